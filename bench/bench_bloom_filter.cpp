@@ -0,0 +1,123 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <cake/BloomFilter.h>
+#include <cake/Workload.h>
+
+namespace {
+
+constexpr double falsePositiveRate = 0.01;
+
+/// Filter holding the keys 0, 1, ..., numElements - 1, built once per size
+const cake::BloomFilter &filledFilter(size_t numElements) {
+    static std::map<size_t, std::unique_ptr<cake::BloomFilter>> filters;
+    auto &filter = filters[numElements];
+
+    if (!filter) {
+        filter = std::make_unique<cake::BloomFilter>(numElements, falsePositiveRate);
+
+        for (uint64_t key = 0; key < numElements; ++key)
+            filter->add(key);
+    }
+
+    return *filter;
+}
+
+/// Numbers of elements: the small filter fits in the caches, the large one does not
+void filterSizes(benchmark::internal::Benchmark *benchmark) {
+    benchmark->Arg(1 << 12)->Arg(1 << 24);
+}
+
+} // namespace
+
+static void BM_BloomFilterAdd(benchmark::State &state) {
+    const auto numElements = static_cast<size_t>(state.range(0));
+    cake::BloomFilter filter(numElements, falsePositiveRate);
+    uint64_t key = 0;
+
+    for (auto _ : state) {
+        filter.add(key);
+        key = key + 1 == numElements ? 0 : key + 1;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BloomFilterAdd)->Apply(filterSizes);
+
+static void BM_BloomFilterContainsPresent(benchmark::State &state) {
+    const auto numElements = static_cast<size_t>(state.range(0));
+    const cake::BloomFilter &filter = filledFilter(numElements);
+    // A stride that is coprime with the size visits the keys out of order
+    const uint64_t stride = 2654435761;
+    uint64_t key = 0;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(filter.contains(key));
+        key = (key + stride) % numElements;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BloomFilterContainsPresent)->Apply(filterSizes);
+
+static void BM_BloomFilterContainsAbsent(benchmark::State &state) {
+    const auto numElements = static_cast<size_t>(state.range(0));
+    const cake::BloomFilter &filter = filledFilter(numElements);
+    uint64_t key = numElements;
+    size_t numFalsePositives = 0;
+
+    for (auto _ : state) {
+        numFalsePositives += filter.contains(key++);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["false_positive_rate"] =
+        static_cast<double>(numFalsePositives) / static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_BloomFilterContainsAbsent)->Apply(filterSizes);
+
+static void BM_BloomFilterContainsUuid(benchmark::State &state) {
+    const auto uuids = cake::Corpus::uuids(static_cast<size_t>(state.range(0)));
+    cake::BloomFilter filter(uuids.size(), falsePositiveRate);
+    size_t i = 0;
+
+    for (size_t j = 0; j < uuids.size(); j += 2)
+        filter.add(uuids[j]);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(filter.contains(uuids[i]));
+        i = i + 1 == uuids.size() ? 0 : i + 1;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BloomFilterContainsUuid)->Arg(1 << 12)->Arg(1 << 20);
@@ -0,0 +1,93 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <cake/DenseDisjointSet.h>
+#include <cake/DisjointSet.h>
+
+namespace {
+
+/// Random edges over the vertices 0, 1, ..., numVertices - 1, twice as many as vertices
+std::vector<std::pair<int, int>> randomEdges(int numVertices) {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> vertex(0, numVertices - 1);
+    std::vector<std::pair<int, int>> edges(2 * static_cast<size_t>(numVertices));
+
+    for (auto &edge : edges)
+        edge = {vertex(generator), vertex(generator)};
+
+    return edges;
+}
+
+} // namespace
+
+static void BM_DisjointSetJoin(benchmark::State &state) {
+    const auto edges = randomEdges(static_cast<int>(state.range(0)));
+
+    for (auto _ : state) {
+        cake::DisjointSet<int> disjointSet;
+
+        benchmark::DoNotOptimize(disjointSet.joinAll(edges));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(edges.size()));
+}
+BENCHMARK(BM_DisjointSetJoin)->RangeMultiplier(16)->Range(1 << 10, 1 << 20);
+
+static void BM_DisjointSetFind(benchmark::State &state) {
+    const int numVertices = static_cast<int>(state.range(0));
+    cake::DisjointSet<int> disjointSet;
+    int vertex = 0;
+
+    disjointSet.joinAll(randomEdges(numVertices));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(disjointSet.find(vertex));
+        vertex = vertex + 1 == numVertices ? 0 : vertex + 1;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DisjointSetFind)->RangeMultiplier(16)->Range(1 << 10, 1 << 20);
+
+static void BM_DenseDisjointSetJoin(benchmark::State &state) {
+    const auto edges = randomEdges(static_cast<int>(state.range(0)));
+
+    for (auto _ : state) {
+        cake::DenseDisjointSet<int> disjointSet(static_cast<size_t>(state.range(0)));
+
+        for (const auto &[vertex1, vertex2] : edges)
+            disjointSet.join(vertex1, vertex2);
+
+        benchmark::DoNotOptimize(disjointSet.numSets());
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(edges.size()));
+}
+BENCHMARK(BM_DenseDisjointSetJoin)->RangeMultiplier(16)->Range(1 << 10, 1 << 20);
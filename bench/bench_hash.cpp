@@ -0,0 +1,51 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <cake/Hash.h>
+
+static void BM_Murmur64A(benchmark::State &state) {
+    const std::vector<char> key(static_cast<size_t>(state.range(0)), 'k');
+    uint64_t seed = 0;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cake::Hash::murmur64A(key.data(), key.size(), seed++));
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Murmur64A)->RangeMultiplier(4)->Range(8, 4096);
+
+static void BM_Murmur64AFundamental(benchmark::State &state) {
+    uint64_t key = 0;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cake::Hash::murmur64A(key++, 42));
+    }
+}
+BENCHMARK(BM_Murmur64AFundamental);
@@ -0,0 +1,130 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <cake/LRUCache.h>
+#include <cake/Workload.h>
+
+namespace {
+
+constexpr size_t numKeys = 1 << 20;
+constexpr uint64_t universeSize = 1 << 20;
+
+/// Draws the keys of a workload up front, so the generator is not part of the measurement
+template <typename TGenerator> std::vector<uint64_t> drawKeys(TGenerator generator) {
+    std::vector<uint64_t> keys(numKeys);
+
+    for (auto &key : keys)
+        key = generator.next();
+
+    return keys;
+}
+
+/**
+ * Looks up keys in a cache of a given size, inserting the missing ones, as a cache in
+ * front of a backend would.
+ */
+void lookUp(benchmark::State &state, const std::vector<uint64_t> &keys) {
+    cake::LRUCache<uint64_t, uint64_t> cache(static_cast<size_t>(state.range(0)));
+    size_t i = 0;
+    size_t numHits = 0;
+
+    for (auto _ : state) {
+        const uint64_t key = keys[i];
+        const uint64_t *value = cache.find(key);
+
+        if (value != nullptr) {
+            benchmark::DoNotOptimize(*value);
+            ++numHits;
+        } else {
+            cache.insert(key, key);
+        }
+
+        i = i + 1 == keys.size() ? 0 : i + 1;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["hit_ratio"] =
+        static_cast<double>(numHits) / static_cast<double>(state.iterations());
+}
+
+} // namespace
+
+// Skewed keys, so a cache of a small fraction of the universe gets mostly hits
+static void BM_LRUCacheZipfian(benchmark::State &state) {
+    static const auto keys = drawKeys(cake::ScrambledZipfianGenerator(universeSize, 0.99));
+
+    lookUp(state, keys);
+}
+BENCHMARK(BM_LRUCacheZipfian)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+
+// Uniform keys, so a cache of a small fraction of the universe gets mostly misses
+static void BM_LRUCacheUniform(benchmark::State &state) {
+    static const auto keys = drawKeys(cake::ZipfianGenerator(universeSize, 0.0));
+
+    lookUp(state, keys);
+}
+BENCHMARK(BM_LRUCacheUniform)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+
+// A hot working set that drifts, so the cache must keep adapting
+static void BM_LRUCacheTemporal(benchmark::State &state) {
+    static const auto keys = drawKeys(cake::TemporalLocalityGenerator(1 << 14, 1 << 16, 1 << 12));
+
+    lookUp(state, keys);
+}
+BENCHMARK(BM_LRUCacheTemporal)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+
+// Replays the access trace named by CAKE_BENCH_TRACE, if any, in the AccessTrace format
+static void BM_LRUCacheTrace(benchmark::State &state, const char *path) {
+    std::ifstream input(path, std::ios::binary);
+    cake::AccessTraceReader reader(input);
+    std::vector<uint64_t> keys;
+
+    cake::replayTrace(reader, [&keys](uint64_t key) { keys.push_back(key); });
+
+    if (keys.empty()) {
+        state.SkipWithError("Empty or unreadable trace");
+        return;
+    }
+
+    lookUp(state, keys);
+}
+
+static const bool traceRegistered = []() {
+    const char *path = std::getenv("CAKE_BENCH_TRACE");
+
+    if (path != nullptr) {
+        benchmark::RegisterBenchmark("BM_LRUCacheTrace", BM_LRUCacheTrace, path)
+            ->RangeMultiplier(16)
+            ->Range(1 << 8, 1 << 16);
+    }
+
+    return path != nullptr;
+}();
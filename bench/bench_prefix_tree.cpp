@@ -0,0 +1,108 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <cake/PrefixTree.h>
+#include <cake/Workload.h>
+
+static void BM_PrefixTreeAdd(benchmark::State &state) {
+    const auto words = cake::Corpus::words(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        cake::PrefixTree<std::string> trie;
+
+        for (const auto &word : words)
+            trie.add(word);
+
+        benchmark::DoNotOptimize(trie.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PrefixTreeAdd)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+
+static void BM_PrefixTreeBulkBuild(benchmark::State &state) {
+    const auto words = cake::Corpus::words(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        const cake::PrefixTree<std::string> trie(words);
+
+        benchmark::DoNotOptimize(trie.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PrefixTreeBulkBuild)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+
+static void BM_PrefixTreeQuery(benchmark::State &state) {
+    static const auto words = cake::Corpus::words(1 << 18);
+    static const cake::PrefixTree<std::string> trie(words);
+    const auto prefixLength = static_cast<size_t>(state.range(0));
+    size_t i = 0;
+    size_t numResults = 0;
+
+    for (auto _ : state) {
+        numResults += trie.query(words[i].substr(0, prefixLength)).size();
+        i = i + 1 == words.size() ? 0 : i + 1;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["results"] =
+        static_cast<double>(numResults) / static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_PrefixTreeQuery)->DenseRange(2, 4);
+
+static void BM_PrefixTreeTopK(benchmark::State &state) {
+    static const auto words = cake::Corpus::words(1 << 18);
+    static const cake::PrefixTree<std::string, cake::NodeArena, double> trie(words);
+    size_t i = 0;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(trie.topK(words[i].substr(0, 2), 10));
+        i = i + 1 == words.size() ? 0 : i + 1;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PrefixTreeTopK);
+
+static void BM_PrefixTreeBulkBuildUrls(benchmark::State &state) {
+    const auto urls = cake::Corpus::urls(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        const cake::PrefixTree<std::string> trie(urls);
+
+        benchmark::DoNotOptimize(trie.size());
+    }
+
+    const cake::PrefixTree<std::string> trie(urls);
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["bytes"] = static_cast<double>(trie.memoryUsage());
+}
+BENCHMARK(BM_PrefixTreeBulkBuildUrls)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
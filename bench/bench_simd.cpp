@@ -0,0 +1,127 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <cake/Simd.h>
+
+namespace {
+
+/**
+ * Makes the kernels run the implementations of the level given as the first argument of a
+ * benchmark, and restores the detected level when the benchmark ends.
+ */
+class LevelScope {
+  public:
+    explicit LevelScope(benchmark::State &state)
+        : m_supported(cake::Simd::setLevel(static_cast<cake::Simd::Level>(state.range(0)))) {
+        state.SetLabel(cake::Simd::levelName(static_cast<cake::Simd::Level>(state.range(0))));
+
+        if (!m_supported)
+            state.SkipWithError("level not supported by this CPU");
+    }
+
+    ~LevelScope() { cake::Simd::setLevel(cake::Simd::supportedLevel()); }
+
+    bool supported() const { return m_supported; }
+
+  private:
+    bool m_supported;
+};
+
+std::vector<uint64_t> randomWords(size_t numWords) {
+    std::mt19937_64 generator(42);
+    std::vector<uint64_t> words(numWords);
+
+    for (auto &word : words)
+        word = generator();
+
+    return words;
+}
+
+/// Every level, with a second argument from a given list
+void levelsAnd(benchmark::internal::Benchmark *benchmark, const std::vector<int64_t> &values) {
+    for (int level = 0; level <= static_cast<int>(cake::Simd::Level::Avx512); ++level) {
+        for (const auto value : values)
+            benchmark->Args({level, value});
+    }
+}
+
+} // namespace
+
+static void BM_SimdPopcount(benchmark::State &state) {
+    LevelScope scope(state);
+    const auto words = randomWords(static_cast<size_t>(state.range(1)));
+
+    for (auto _ : state) {
+        if (!scope.supported())
+            break;
+
+        benchmark::DoNotOptimize(cake::Simd::popcount(words.data(), words.size()));
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(1) * sizeof(uint64_t));
+}
+BENCHMARK(BM_SimdPopcount)->Apply([](auto *benchmark) { levelsAnd(benchmark, {8, 4096}); });
+
+static void BM_SimdBitwiseOr(benchmark::State &state) {
+    LevelScope scope(state);
+    auto target = randomWords(static_cast<size_t>(state.range(1)));
+    const auto source = randomWords(static_cast<size_t>(state.range(1)));
+
+    for (auto _ : state) {
+        if (!scope.supported())
+            break;
+
+        cake::Simd::bitwiseOr(target.data(), source.data(), target.size());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(1) * sizeof(uint64_t));
+}
+BENCHMARK(BM_SimdBitwiseOr)->Apply([](auto *benchmark) { levelsAnd(benchmark, {8, 4096}); });
+
+static void BM_SimdMurmur64A(benchmark::State &state) {
+    LevelScope scope(state);
+    // 7 seeds is what a Bloom filter with a 1% false positive rate uses
+    const auto seeds = randomWords(static_cast<size_t>(state.range(1)));
+    std::vector<uint64_t> hashes(seeds.size());
+    const std::string key = "f47ac10b-58cc-4372-a567-0e02b2c3d479";
+
+    for (auto _ : state) {
+        if (!scope.supported())
+            break;
+
+        cake::Simd::murmur64A(key.data(), key.size(), seeds.data(), hashes.data(), seeds.size());
+        benchmark::DoNotOptimize(hashes.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_SimdMurmur64A)->Apply([](auto *benchmark) { levelsAnd(benchmark, {7, 32}); });
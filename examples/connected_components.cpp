@@ -0,0 +1,162 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Parallel connected components with ConcurrentDisjointSet.
+ *
+ * Usage: connected_components [edge list file] [maximum number of threads]
+ *
+ * The edge list has one edge per line, as two vertices in the range [0, number of vertices).
+ * Without a file, a random graph is generated. The components are computed with 1, 2, 4, ...
+ * threads up to the maximum, each thread joining a contiguous slice of the edges, and the
+ * time of every run is reported along with its speedup over the single threaded run.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cake/ConcurrentDisjointSet.h>
+#include <cake/DenseDisjointSet.h>
+
+namespace {
+
+using Edge = std::pair<long long, long long>;
+
+bool readEdges(const char *path, std::vector<Edge> &edges, long long &numVertices) {
+    std::ifstream input(path);
+    long long from = 0;
+    long long to = 0;
+
+    if (!input)
+        return false;
+
+    while (input >> from >> to) {
+        if (from < 0 || to < 0)
+            return false;
+
+        edges.emplace_back(from, to);
+        numVertices = std::max(numVertices, std::max(from, to) + 1);
+    }
+
+    return input.eof();
+}
+
+void generateEdges(long long numVertices, size_t numEdges, std::vector<Edge> &edges) {
+    std::mt19937_64 generator(42);
+    std::uniform_int_distribution<long long> vertex(0, numVertices - 1);
+
+    edges.reserve(numEdges);
+
+    for (size_t i = 0; i < numEdges; ++i)
+        edges.emplace_back(vertex(generator), vertex(generator));
+}
+
+size_t countComponents(const std::vector<Edge> &edges, long long numVertices, size_t numThreads,
+                       double &seconds) {
+    cake::ConcurrentDisjointSet<long long> components(static_cast<size_t>(numVertices));
+    std::vector<std::thread> threads;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (size_t thread = 0; thread < numThreads; ++thread) {
+        threads.emplace_back([&, thread]() {
+            const size_t first = edges.size() * thread / numThreads;
+            const size_t last = edges.size() * (thread + 1) / numThreads;
+
+            for (size_t i = first; i < last; ++i)
+                components.join(edges[i].first, edges[i].second);
+        });
+    }
+
+    for (auto &thread : threads)
+        thread.join();
+
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t numComponents = 0;
+
+    for (long long vertex = 0; vertex < numVertices; ++vertex)
+        numComponents += components.find(vertex) == vertex;
+
+    return numComponents;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::vector<Edge> edges;
+    long long numVertices = 0;
+
+    if (argc > 1) {
+        if (!readEdges(argv[1], edges, numVertices)) {
+            std::fprintf(stderr, "Could not read edge list %s\n", argv[1]);
+            return EXIT_FAILURE;
+        }
+    } else {
+        numVertices = 1 << 22;
+        generateEdges(numVertices, 2 * static_cast<size_t>(numVertices), edges);
+    }
+
+    const size_t maxThreads =
+        argc > 2 ? std::max(1L, std::atol(argv[2]))
+                 : std::max(1U, std::thread::hardware_concurrency());
+
+    // Single threaded reference
+    cake::DenseDisjointSet<long long> reference(static_cast<size_t>(numVertices));
+
+    for (const auto &[from, to] : edges)
+        reference.join(from, to);
+
+    std::printf("%lld vertices, %zu edges, %zu components\n", numVertices, edges.size(),
+                reference.numSets());
+    std::printf("%8s %10s %8s\n", "threads", "seconds", "speedup");
+
+    double baseSeconds = 0.0;
+
+    for (size_t numThreads = 1; numThreads <= maxThreads;
+         numThreads = numThreads == maxThreads ? maxThreads + 1
+                                               : std::min(2 * numThreads, maxThreads)) {
+        double seconds = 0.0;
+        const size_t numComponents = countComponents(edges, numVertices, numThreads, seconds);
+
+        if (numComponents != reference.numSets()) {
+            std::fprintf(stderr, "Found %zu components with %zu threads, expected %zu\n",
+                         numComponents, numThreads, reference.numSets());
+            return EXIT_FAILURE;
+        }
+
+        if (numThreads == 1)
+            baseSeconds = seconds;
+
+        std::printf("%8zu %10.3f %8.2f\n", numThreads, seconds, baseSeconds / seconds);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,108 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+namespace cake {
+
+/**
+ * Reads a key access trace from a stream. A trace is a binary sequence of 64-bit keys in
+ * little-endian order, one per access, with no header. The trace is streamed through a fixed
+ * size buffer, so traces of any length can be read.
+ */
+class AccessTraceReader {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param input Stream the trace is read from. It must outlive the reader.
+     * @param bufferSize Number of keys read from the stream at once.
+     */
+    explicit AccessTraceReader(std::istream &input, size_t bufferSize = 1 << 16);
+
+    /**
+     * Reads the next key of the trace.
+     *
+     * @param key Set to the next key, if there is one.
+     *
+     * @return true if a key was read, false if the trace is over.
+     */
+    bool next(uint64_t &key);
+
+  private:
+    /**
+     * Refills the buffer from the stream.
+     *
+     * @return true if at least one key was read.
+     */
+    bool refill();
+
+  private:
+    std::istream &m_input;
+    std::vector<uint64_t> m_buffer;
+    size_t m_position;
+    size_t m_size;
+};
+
+/**
+ * Writes a key access trace to a stream, in the format read by AccessTraceReader.
+ */
+class AccessTraceWriter {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param output Stream the trace is written to. It must outlive the writer.
+     * @param bufferSize Number of keys written to the stream at once.
+     */
+    explicit AccessTraceWriter(std::ostream &output, size_t bufferSize = 1 << 16);
+
+    /**
+     * Destructor. Flushes the keys that are still buffered.
+     */
+    ~AccessTraceWriter();
+
+    /**
+     * Appends an access to a given key to the trace.
+     *
+     * @param key The given key.
+     */
+    void write(uint64_t key);
+
+    /**
+     * Writes all the buffered keys to the stream.
+     */
+    void flush();
+
+  private:
+    std::ostream &m_output;
+    std::vector<uint64_t> m_buffer;
+};
+} // namespace cake
@@ -0,0 +1,113 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cake {
+
+/**
+ * Bit vector with rank and select support, as used by succinct data structures. It is a
+ * read-only view over an image made of 64-bit words: the number of bits, the bits, and a
+ * directory with the number of ones before every block of 512 bits. The image can live in
+ * memory owned by someone else (e.g. a memory-mapped file), since the view never copies it.
+ */
+class BitVector {
+  public:
+    /**
+     * Constructor. Creates an empty bit vector.
+     */
+    BitVector();
+
+    /**
+     * Appends the image of a bit vector to a buffer.
+     *
+     * @param image Buffer of 64-bit words.
+     * @param bits Bits of the bit vector.
+     */
+    static void appendImage(std::vector<uint64_t> &image, const std::vector<bool> &bits);
+
+    /**
+     * Makes this bit vector a view of an image. The image must outlive the view. Its stored
+     * ranks are checked against its bits, which takes a pass over them.
+     *
+     * @param data Pointer to the image.
+     * @param numWords Number of 64-bit words available from data.
+     *
+     * @return The number of words the image takes, or 0 if the image is not valid.
+     */
+    size_t view(const uint64_t *data, size_t numWords);
+
+    /** Returns how many bits the bit vector has.
+     *
+     * @return The number of bits.
+     */
+    size_t size() const { return m_numBits; }
+
+    /** Returns how many bits are set.
+     *
+     * @return The number of ones.
+     */
+    size_t numOnes() const { return m_numBits == 0 ? 0 : m_ranks[m_numBlocks]; }
+
+    /**
+     * Returns a bit.
+     *
+     * @param position Position of the bit, which must be less than size().
+     */
+    bool operator[](size_t position) const {
+        return (m_words[position / 64] >> (position % 64)) & 1;
+    }
+
+    /**
+     * Counts the bits set before a given position.
+     *
+     * @param position A position, at most size().
+     *
+     * @return The number of ones in [0, position).
+     */
+    size_t rank1(size_t position) const;
+
+    /**
+     * Finds the position of a set bit.
+     *
+     * @param rank Number of ones before the bit, which must be less than numOnes().
+     *
+     * @return The position of the bit.
+     */
+    size_t select1(size_t rank) const;
+
+  private:
+    static constexpr size_t wordsPerBlock = 8;
+
+    const uint64_t *m_words; /// Bits, least significant first
+    const uint64_t *m_ranks; /// Number of ones before every block, and the total at the end
+    size_t m_numBits;
+    size_t m_numBlocks;
+};
+
+} // namespace cake
@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include <cstdint>
+#include <type_traits>
 #include <vector>
 
 #include <cake/Hash.h>
@@ -82,6 +84,17 @@ class BloomFilter {
      */
     void clear();
 
+    /**
+     * Adds all the elements of another filter to this one. The filters must have been
+     * constructed with the same parameters.
+     *
+     * @param other The other filter.
+     *
+     * @return true, when the filters were merged; false, when their sizes or numbers of hashes
+     * differ, and this filter is left as it was.
+     */
+    bool merge(const BloomFilter &other);
+
     /**
      * Computes the occupancy of the filter. This is a measure of how "full"
      * the filter is.
@@ -95,43 +108,64 @@ class BloomFilter {
      *
      * @return Size of the filter
      */
-    size_t size() const { return m_bitArray.size(); }
+    size_t size() const { return m_numBits; }
+
+    /**
+     * Returns the memory used by the filter, including its bit array.
+     *
+     * @return The number of bytes.
+     */
+    size_t memoryUsage() const {
+        return sizeof(*this) + (m_words.capacity() + m_seeds.capacity()) * sizeof(uint64_t);
+    }
 
   private:
+    static constexpr size_t maxNumHashes = 256;
+
+    /// Number of hashes from which strings and vectors are hashed in batches with AVX-512
+    static constexpr size_t batchNumHashes = 8;
+
     /**
      * Given an object, computes its indices in the bitmap.
      *
      * @param element The given element.
-     *
-     * @return The indices of the element.
+     * @param indices Where the m_numHashes indices of the element are written.
      */
     template <typename TElement>
-    std::vector<size_t> computeElementIndices(const TElement &element) const;
+    void computeElementIndices(const TElement &element, uint64_t *indices) const;
 
   private:
     size_t m_expectedNumElements;
     double m_falsePositiveRate;
     size_t m_numHashes;
-    std::vector<bool> m_bitArray;
+    size_t m_numBits;
+    std::vector<uint64_t> m_words; /// Bits of the filter, least significant first
+    std::vector<uint64_t> m_seeds; /// Seed of every hash
 };
 
 template <typename TElement>
-std::vector<size_t> BloomFilter::computeElementIndices(const TElement &element) const {
-    std::vector<size_t> idxs;
-
-    for (size_t i = 1; i <= m_numHashes; ++i) {
-        const size_t idx = Hash::murmur64A(element, m_bitArray.size() * i) % m_bitArray.size();
-        idxs.push_back(idx);
+void BloomFilter::computeElementIndices(const TElement &element, uint64_t *indices) const {
+    // The inlined scalar hash is the fastest for objects of a fixed size. For strings and
+    // vectors, AVX-512 mixes the data once for 8 seeds, which pays off with a full vector.
+    if (!std::is_fundamental_v<TElement> && m_numHashes >= batchNumHashes &&
+        Simd::activeLevel() == Simd::Level::Avx512) {
+        Hash::murmur64A(element, m_seeds.data(), indices, m_numHashes);
+
+        for (size_t i = 0; i < m_numHashes; ++i)
+            indices[i] %= m_numBits;
+    } else {
+        for (size_t i = 0; i < m_numHashes; ++i)
+            indices[i] = Hash::murmur64A(element, m_seeds[i]) % m_numBits;
     }
-
-    return idxs;
 }
 
 template <typename TElement> bool BloomFilter::contains(const TElement &element) const {
-    const auto indices = computeElementIndices(element);
+    uint64_t indices[maxNumHashes];
 
-    for (const auto idx : indices) {
-        if (!m_bitArray[idx])
+    computeElementIndices(element, indices);
+
+    for (size_t i = 0; i < m_numHashes; ++i) {
+        if (!((m_words[indices[i] / 64] >> (indices[i] % 64)) & 1))
             return false;
     }
 
@@ -139,10 +173,12 @@ template <typename TElement> bool BloomFilter::contains(const TElement &element)
 }
 
 template <typename TElement> void BloomFilter::add(const TElement &element) {
-    const auto indices = computeElementIndices(element);
+    uint64_t indices[maxNumHashes];
+
+    computeElementIndices(element, indices);
 
-    for (const auto idx : indices) {
-        m_bitArray[idx] = true;
+    for (size_t i = 0; i < m_numHashes; ++i) {
+        m_words[indices[i] / 64] |= uint64_t(1) << (indices[i] % 64);
     }
 }
 } // namespace cake
\ No newline at end of file
@@ -0,0 +1,113 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include <cake/Serializer.h>
+
+namespace cake {
+
+/**
+ * Cache snapshots. A snapshot is a binary dump of the entries of a cache in recency order,
+ * from the most to the least recently used, which allows a cache to be warmed up after a
+ * restart. The format is a header (magic number, version, number of entries) followed by
+ * every key and value as written by their serializers.
+ */
+namespace CacheSnapshot {
+
+const uint64_t magic = 0x544f4853454b4143; /// "CAKESHOT" in little-endian
+const uint32_t version = 1;
+
+/**
+ * Writes a snapshot to a stream.
+ *
+ * @param output The stream.
+ * @param entries Key-value pairs, from the most to the least recently used.
+ *
+ * @return true if the snapshot was written successfully.
+ */
+template <typename TKey, typename TValue, typename TKeySerializer = Serializer<TKey>,
+          typename TValueSerializer = Serializer<TValue>>
+bool write(std::ostream &output, const std::vector<std::pair<TKey, TValue>> &entries) {
+    Serializer<uint64_t>::write(output, magic);
+    Serializer<uint32_t>::write(output, version);
+    Serializer<uint64_t>::write(output, entries.size());
+
+    for (const auto &[key, value] : entries) {
+        TKeySerializer::write(output, key);
+        TValueSerializer::write(output, value);
+    }
+
+    return static_cast<bool>(output.flush());
+}
+
+/**
+ * Reads a snapshot from a stream, one entry at a time, so that the whole snapshot never
+ * needs to be in memory.
+ *
+ * @param input The stream.
+ * @param onEntry Callable invoked with the key and value of every entry, from the most to the
+ * least recently used. Reading stops early if it returns false.
+ *
+ * @return true if the snapshot was read successfully (or reading was stopped), false if the
+ * snapshot is not valid or is truncated.
+ */
+template <typename TKey, typename TValue, typename TKeySerializer = Serializer<TKey>,
+          typename TValueSerializer = Serializer<TValue>, typename TCallback>
+bool read(std::istream &input, TCallback &&onEntry) {
+    uint64_t fileMagic;
+    uint32_t fileVersion;
+    uint64_t numEntries;
+
+    if (!Serializer<uint64_t>::read(input, fileMagic) || fileMagic != magic)
+        return false;
+
+    if (!Serializer<uint32_t>::read(input, fileVersion) || fileVersion != version)
+        return false;
+
+    if (!Serializer<uint64_t>::read(input, numEntries))
+        return false;
+
+    TKey key;
+    TValue value;
+
+    for (uint64_t i = 0; i < numEntries; ++i) {
+        if (!TKeySerializer::read(input, key) || !TValueSerializer::read(input, value))
+            return false;
+
+        if (!onEntry(key, value))
+            break;
+    }
+
+    return true;
+}
+} // namespace CacheSnapshot
+} // namespace cake
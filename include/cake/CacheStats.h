@@ -0,0 +1,187 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace cake {
+
+/**
+ * Snapshot of the statistics of a cache. All zeros when statistics are not collected.
+ */
+struct CacheStats {
+    static constexpr size_t numLatencyBuckets = 32;
+
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t inserts = 0;
+    uint64_t evictions = 0;        /// Entries removed to make room for others
+    uint64_t expirations = 0;      /// Entries removed because their time to live ran out
+    uint64_t explicitRemovals = 0; /// Entries removed through remove()
+    uint64_t replacements = 0;     /// Entries overwritten by an insert with the same key
+
+    /**
+     * Histogram of sampled access latencies. Bucket i counts accesses that took less than
+     * 2^i nanoseconds (and at least 2^(i-1)); the last bucket also counts anything slower.
+     */
+    std::array<uint64_t, numLatencyBuckets> accessLatencies{};
+
+    /**
+     * Returns the fraction of lookups that were hits, or zero if there were no lookups.
+     */
+    double hitRatio() const {
+        const uint64_t lookups = hits + misses;
+        return lookups == 0 ? 0.0 : static_cast<double>(hits) / lookups;
+    }
+};
+
+/**
+ * Statistics policies of caches, given as a template parameter. A policy provides the
+ * record*() calls made by the cache, timeAccess(), which returns an object that measures an
+ * access until destroyed, and snapshot().
+ */
+
+/**
+ * Statistics policy that records nothing. It is empty, and its calls compile to nothing, so a
+ * cache that does not collect statistics pays nothing for them.
+ */
+class NoCacheStats {
+  public:
+    /**
+     * Measures the latency of an access, if it is sampled, until destroyed.
+     */
+    class AccessTimer {};
+
+    AccessTimer timeAccess() { return AccessTimer(); }
+    void recordHit() {}
+    void recordMiss() {}
+    void recordInsert() {}
+    void recordEviction() {}
+    void recordExpiration() {}
+    void recordExplicitRemoval() {}
+    void recordReplacement() {}
+    CacheStats snapshot() const { return CacheStats(); }
+};
+
+/**
+ * Statistics policy that counts with relaxed atomic increments, a few per operation, and
+ * samples access latencies. The counters can be read from any thread.
+ */
+class CacheStatsRecorder {
+  public:
+    /// One every latencySampleInterval accesses is timed, to keep clock reads off most of them
+    static constexpr uint64_t latencySampleInterval = 64;
+
+    class AccessTimer {
+      public:
+        explicit AccessTimer(CacheStatsRecorder *recorder)
+            : m_recorder(recorder), m_start(std::chrono::steady_clock::now()) {}
+        AccessTimer() : m_recorder(nullptr) {}
+        AccessTimer(const AccessTimer &) = delete;
+        AccessTimer &operator=(const AccessTimer &) = delete;
+
+        ~AccessTimer() {
+            if (m_recorder == nullptr)
+                return;
+
+            const auto elapsed = std::chrono::steady_clock::now() - m_start;
+            const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed);
+            m_recorder->recordLatency(static_cast<uint64_t>(nanos.count()));
+        }
+
+      private:
+        CacheStatsRecorder *m_recorder;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    CacheStatsRecorder() = default;
+    CacheStatsRecorder(const CacheStatsRecorder &) = delete;
+    CacheStatsRecorder &operator=(const CacheStatsRecorder &) = delete;
+
+    AccessTimer timeAccess() {
+        if (m_numAccesses.fetch_add(1, std::memory_order_relaxed) % latencySampleInterval != 0)
+            return AccessTimer();
+
+        return AccessTimer(this);
+    }
+
+    void recordHit() { increment(m_hits); }
+    void recordMiss() { increment(m_misses); }
+    void recordInsert() { increment(m_inserts); }
+    void recordEviction() { increment(m_evictions); }
+    void recordExpiration() { increment(m_expirations); }
+    void recordExplicitRemoval() { increment(m_explicitRemovals); }
+    void recordReplacement() { increment(m_replacements); }
+
+    /**
+     * Takes a snapshot of the statistics. It may be called from a thread other than the one
+     * using the cache; counters are read individually, so the snapshot is not atomic as a
+     * whole.
+     */
+    CacheStats snapshot() const {
+        CacheStats stats;
+        stats.hits = m_hits.load(std::memory_order_relaxed);
+        stats.misses = m_misses.load(std::memory_order_relaxed);
+        stats.inserts = m_inserts.load(std::memory_order_relaxed);
+        stats.evictions = m_evictions.load(std::memory_order_relaxed);
+        stats.expirations = m_expirations.load(std::memory_order_relaxed);
+        stats.explicitRemovals = m_explicitRemovals.load(std::memory_order_relaxed);
+        stats.replacements = m_replacements.load(std::memory_order_relaxed);
+
+        for (size_t i = 0; i < CacheStats::numLatencyBuckets; ++i)
+            stats.accessLatencies[i] = m_accessLatencies[i].load(std::memory_order_relaxed);
+
+        return stats;
+    }
+
+  private:
+    static void increment(std::atomic<uint64_t> &counter) {
+        counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void recordLatency(uint64_t nanos) {
+        size_t bucket = 0;
+        while (bucket + 1 < CacheStats::numLatencyBuckets && (nanos >> bucket) != 0)
+            ++bucket;
+
+        increment(m_accessLatencies[bucket]);
+    }
+
+  private:
+    std::atomic<uint64_t> m_numAccesses{0};
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<uint64_t> m_misses{0};
+    std::atomic<uint64_t> m_inserts{0};
+    std::atomic<uint64_t> m_evictions{0};
+    std::atomic<uint64_t> m_expirations{0};
+    std::atomic<uint64_t> m_explicitRemovals{0};
+    std::atomic<uint64_t> m_replacements{0};
+    std::array<std::atomic<uint64_t>, CacheStats::numLatencyBuckets> m_accessLatencies{};
+};
+} // namespace cake
@@ -0,0 +1,194 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace cake {
+
+/**
+ * Lock-free Disjoint Set of the dense integer elements 0, 1, ..., size() - 1, for use by many
+ * threads at once. The parent of every element is atomic, and the root of a set is its own
+ * parent. join links the root with the larger index under the other with a compare-and-swap,
+ * so parents always have smaller indices than their children, and the forest stays acyclic
+ * whatever the interleaving. find halves the paths it walks with compare-and-swaps, which
+ * may fail harmlessly when another thread changed the parent first.
+ *
+ * All operations are linearizable: join takes effect at its successful compare-and-swap, and
+ * sameSet only answers false after seeing a root that is still a root.
+ */
+template <typename TElement> class ConcurrentDisjointSet {
+    static_assert(std::is_integral_v<TElement> && std::is_signed_v<TElement>,
+                  "Elements must be of a signed integer type");
+
+  public:
+    using element_type = TElement;
+
+    /**
+     * Constructor. Creates a disjoint set with a given number of elements, each in its own
+     * set.
+     *
+     * @param numElements Number of elements.
+     */
+    explicit ConcurrentDisjointSet(size_t numElements);
+
+    ConcurrentDisjointSet(const ConcurrentDisjointSet &) = delete;
+    ConcurrentDisjointSet &operator=(const ConcurrentDisjointSet &) = delete;
+
+    /**
+     * Returns the number of elements.
+     *
+     * @return The number of elements.
+     */
+    size_t size() const { return m_size; }
+
+    /**
+     * Finds the representative of the set of an element, halving the path to it. Concurrent
+     * joins may change the representative right after it is returned.
+     *
+     * @param element The element. Elements out of range are in sets of their own.
+     * @return The representative of the set.
+     */
+    element_type find(element_type element) const;
+
+    /**
+     * Merges the sets of two elements.
+     *
+     * @param element1 The first element.
+     * @param element2 The second element.
+     * @return true, if this call merged the sets; false, if the elements were already in the
+     *         same set, or any of them is out of range.
+     */
+    bool join(element_type element1, element_type element2);
+
+    /**
+     * Tests whether two elements are in the same set.
+     *
+     * @param element1 The first element.
+     * @param element2 The second element.
+     * @return true, if the elements are in the same set; false, otherwise.
+     */
+    bool sameSet(element_type element1, element_type element2) const;
+
+    /**
+     * Returns the memory used by the disjoint set.
+     *
+     * @return The number of bytes.
+     */
+    size_t memoryUsage() const {
+        return sizeof(*this) + m_size * sizeof(std::atomic<element_type>);
+    }
+
+  private:
+    bool contains(element_type element) const {
+        return element >= 0 && static_cast<size_t>(element) < m_size;
+    }
+
+    bool isRoot(element_type element) const {
+        return m_parents[element].load() == element;
+    }
+
+    size_t m_size;
+    /// Parent of every element. Halving in find does not change any set, so it is mutable.
+    mutable std::unique_ptr<std::atomic<element_type>[]> m_parents;
+};
+
+template <typename TElement>
+ConcurrentDisjointSet<TElement>::ConcurrentDisjointSet(size_t numElements)
+    : m_size(numElements), m_parents(new std::atomic<element_type>[numElements]) {
+    for (size_t i = 0; i < numElements; ++i)
+        m_parents[i].store(static_cast<element_type>(i), std::memory_order_relaxed);
+}
+
+template <typename TElement>
+TElement ConcurrentDisjointSet<TElement>::find(element_type element) const {
+    if (!contains(element))
+        return element;
+
+    // Parents only ever point to smaller indices, so any value read is safe to follow, and
+    // the ordering of the links is left to join and sameSet
+    while (true) {
+        element_type parent = m_parents[element].load(std::memory_order_relaxed);
+
+        if (parent == element)
+            return element;
+
+        const element_type grandparent = m_parents[parent].load(std::memory_order_relaxed);
+
+        if (grandparent != parent) {
+            m_parents[element].compare_exchange_weak(parent, grandparent,
+                                                     std::memory_order_relaxed);
+        }
+
+        element = grandparent;
+    }
+}
+
+template <typename TElement>
+bool ConcurrentDisjointSet<TElement>::join(element_type element1, element_type element2) {
+    if (!contains(element1) || !contains(element2))
+        return false;
+
+    while (true) {
+        element1 = find(element1);
+        element2 = find(element2);
+
+        if (element1 == element2)
+            return false;
+
+        if (element1 < element2)
+            std::swap(element1, element2);
+
+        // Fails if element1 stopped being a root, and then the roots are found again
+        element_type expected = element1;
+
+        if (m_parents[element1].compare_exchange_strong(expected, element2))
+            return true;
+    }
+}
+
+template <typename TElement>
+bool ConcurrentDisjointSet<TElement>::sameSet(element_type element1,
+                                               element_type element2) const {
+    if (!contains(element1) || !contains(element2))
+        return element1 == element2;
+
+    while (true) {
+        element1 = find(element1);
+        element2 = find(element2);
+
+        if (element1 == element2)
+            return true;
+
+        // Otherwise a concurrent join linked element1 after it was found
+        if (isRoot(element1))
+            return false;
+    }
+}
+
+} // namespace cake
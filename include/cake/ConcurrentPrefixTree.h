@@ -0,0 +1,461 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cake {
+
+/**
+ * Prefix Tree that can be read from many threads while it is being modified. Same interface
+ * and results as PrefixTree.
+ *
+ * Nodes are never modified once published. A writer copies the nodes on the path to the
+ * word it adds or removes, and publishes the new version by swapping the root atomically, so
+ * readers never take locks and always see a consistent version of the tree. Writers are
+ * serialized by a mutex.
+ *
+ * The replaced nodes are reclaimed with epochs: a reader announces the current epoch while it
+ * uses the tree, and every update advances the epoch after publishing its root. Nodes retired
+ * in an epoch are freed once every active reader announced a later one, since such readers
+ * can only have loaded a newer root.
+ */
+template <typename TString> class ConcurrentPrefixTree {
+  public:
+    using string_type = TString;
+    using symbol_type = typename TString::value_type;
+
+    /// Maximum number of threads that can read at the same time; more readers wait for a slot
+    static constexpr size_t maxReaders = 128;
+
+    /**
+     * Constructor. Creates an empty prefix tree.
+     */
+    ConcurrentPrefixTree();
+
+    /**
+     * Constructor. Creates a prefix tree with all the words in a given vector.
+     *
+     * @param words Container of words.
+     */
+    ConcurrentPrefixTree(const std::vector<string_type> &words);
+
+    ConcurrentPrefixTree(const ConcurrentPrefixTree &) = delete;
+    ConcurrentPrefixTree &operator=(const ConcurrentPrefixTree &) = delete;
+
+    /**
+     * Destructor. There must be no readers or writers left.
+     */
+    ~ConcurrentPrefixTree();
+
+    /** Returns how many words the prefix tree contains.
+     *
+     * @return The number of words in the prefix tree.
+     */
+    size_t size() const { return m_size.load(std::memory_order_relaxed); }
+
+    /**
+     * Returns the memory used by the prefix tree: the tree object, the nodes of the current
+     * version, and the retired nodes that readers may still be using. It is kept up to date
+     * by the writers, so this takes constant time.
+     *
+     * @return The number of bytes.
+     */
+    size_t memoryUsage() const { return m_memoryUsage.load(std::memory_order_relaxed); }
+
+    /**
+     * Add a new word to the prefix tree, if the word was not already present.
+     *
+     * @param word Given word.
+     *
+     * @return true if the new word is not empty and was not already present, otherwise false.
+     */
+    bool add(const string_type &word);
+
+    /**
+     * Remove a word from the prefix tree.
+     *
+     * @param word Given word.
+     *
+     * @return true if the word was removed, otherwise false.
+     */
+    bool remove(const string_type &word);
+
+    /**
+     * Query prefix tree for all words that match a given prefix. Sees the tree as it was
+     * when the query started, regardless of concurrent updates.
+     *
+     * @param prefix A given prefix.
+     *
+     * @return A vector with all the words in the prefix tree that match the given prefix.
+     */
+    std::vector<string_type> query(const string_type &prefix) const;
+
+  private:
+    using key_type = std::make_unsigned_t<symbol_type>;
+
+    struct Node {
+        bool isWordEnd = false;
+        std::vector<key_type> keys; /// Sorted
+        std::vector<const Node *> children;
+
+        /**
+         * Returns the position of the child for a given key, or the position where it would
+         * be inserted.
+         */
+        size_t position(key_type key) const {
+            return std::lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+        }
+
+        const Node *findChild(key_type key) const {
+            const size_t i = position(key);
+
+            return i < keys.size() && keys[i] == key ? children[i] : nullptr;
+        }
+
+        /// Bytes of the node and of its arrays
+        size_t memoryUsage() const {
+            return sizeof(Node) + keys.capacity() * sizeof(key_type) +
+                   children.capacity() * sizeof(const Node *);
+        }
+    };
+
+    /// Epoch announced by a reader, or zero if the slot is free
+    struct alignas(64) ReaderSlot {
+        std::atomic<uint64_t> epoch{0};
+    };
+
+    /// Announces the current epoch for as long as it lives
+    class ReadGuard {
+      public:
+        explicit ReadGuard(const ConcurrentPrefixTree &tree);
+        ~ReadGuard() { m_slot.epoch.store(0, std::memory_order_release); }
+
+      private:
+        ReaderSlot &m_slot;
+
+        static ReaderSlot &acquire(const ConcurrentPrefixTree &tree);
+    };
+
+    /**
+     * Finds the nodes on the path to a word.
+     *
+     * @param path Set to the nodes from the root to the last node of the word that exists.
+     */
+    void findPath(const string_type &word, std::vector<const Node *> &path) const;
+
+    /**
+     * Publishes a new root, and retires the nodes it no longer uses.
+     *
+     * @param word Word that was updated. The nodes of the new version along it are new.
+     */
+    void publish(const Node *root, const string_type &word,
+                 const std::vector<const Node *> &retired);
+
+    /**
+     * Frees the retired nodes that no reader can be using.
+     */
+    void reclaim();
+
+    static void collect(const Node *node, string_type &buffer, std::vector<string_type> &result);
+    static void destroyTree(const Node *node);
+
+    std::atomic<const Node *> m_root;
+    std::atomic<size_t> m_size;
+    std::atomic<size_t> m_memoryUsage; /// Only updated by writers
+    std::atomic<uint64_t> m_epoch; /// Starts at 1, since 0 marks a free reader slot
+    mutable ReaderSlot m_readers[maxReaders];
+    std::mutex m_writeMutex;
+    std::vector<std::pair<uint64_t, std::vector<const Node *>>> m_retired; /// By epoch
+};
+
+template <typename TString>
+ConcurrentPrefixTree<TString>::ConcurrentPrefixTree()
+    : m_root(new Node()), m_size(0), m_memoryUsage(sizeof(*this) + sizeof(Node)), m_epoch(1) {}
+
+template <typename TString>
+ConcurrentPrefixTree<TString>::ConcurrentPrefixTree(const std::vector<string_type> &words)
+    : ConcurrentPrefixTree() {
+    for (const auto &word : words) {
+        add(word);
+    }
+}
+
+template <typename TString> ConcurrentPrefixTree<TString>::~ConcurrentPrefixTree() {
+    for (const auto &[epoch, nodes] : m_retired) {
+        for (const Node *node : nodes)
+            delete node;
+    }
+
+    destroyTree(m_root.load());
+}
+
+template <typename TString>
+ConcurrentPrefixTree<TString>::ReadGuard::ReadGuard(const ConcurrentPrefixTree &tree)
+    : m_slot(acquire(tree)) {}
+
+template <typename TString>
+typename ConcurrentPrefixTree<TString>::ReaderSlot &
+ConcurrentPrefixTree<TString>::ReadGuard::acquire(const ConcurrentPrefixTree &tree) {
+    // Threads start probing at different slots, so they rarely contend for one
+    size_t slot = std::hash<std::thread::id>()(std::this_thread::get_id()) % maxReaders;
+
+    for (size_t probes = 1;; ++probes) {
+        uint64_t free = 0;
+
+        // The announced epoch may be older than the current one by now, which is safe
+        if (tree.m_readers[slot].epoch.compare_exchange_strong(free, tree.m_epoch.load()))
+            return tree.m_readers[slot];
+
+        slot = (slot + 1) % maxReaders;
+
+        if (probes % maxReaders == 0)
+            std::this_thread::yield();
+    }
+}
+
+template <typename TString> bool ConcurrentPrefixTree<TString>::add(const string_type &word) {
+    if (word.empty())
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    std::vector<const Node *> path;
+
+    findPath(word, path);
+
+    const size_t depth = path.size() - 1;
+
+    if (depth == word.size() && path.back()->isWordEnd)
+        return false;
+
+    // New nodes for the missing suffix of the word, from the bottom up
+    Node *child = nullptr;
+
+    if (depth == word.size()) {
+        child = new Node(*path.back());
+        child->isWordEnd = true;
+    } else {
+        child = new Node();
+        child->isWordEnd = true;
+
+        for (size_t i = word.size() - 1; i > depth; --i) {
+            Node *parent = new Node();
+
+            parent->keys.push_back(static_cast<key_type>(word[i]));
+            parent->children.push_back(child);
+            child = parent;
+        }
+
+        // Copy of the last existing node, with the new suffix
+        Node *parent = new Node(*path.back());
+        const auto key = static_cast<key_type>(word[depth]);
+        const size_t position = parent->position(key);
+
+        parent->keys.insert(parent->keys.begin() + position, key);
+        parent->children.insert(parent->children.begin() + position, child);
+        child = parent;
+    }
+
+    // Copies of the ancestors, pointing to the new nodes
+    for (size_t i = path.size() - 1; i-- > 0;) {
+        Node *parent = new Node(*path[i]);
+
+        parent->children[parent->position(static_cast<key_type>(word[i]))] = child;
+        child = parent;
+    }
+
+    publish(child, word, path);
+    m_size.fetch_add(1, std::memory_order_relaxed);
+
+    return true;
+}
+
+template <typename TString> bool ConcurrentPrefixTree<TString>::remove(const string_type &word) {
+    if (word.empty())
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    std::vector<const Node *> path;
+
+    findPath(word, path);
+
+    if (path.size() - 1 != word.size() || !path.back()->isWordEnd)
+        return false;
+
+    // nullptr while the nodes are pruned because they no longer lead to any word
+    Node *child = nullptr;
+
+    if (!path.back()->children.empty()) {
+        child = new Node(*path.back());
+        child->isWordEnd = false;
+    }
+
+    for (size_t i = path.size() - 1; i-- > 0;) {
+        const auto key = static_cast<key_type>(word[i]);
+        const Node *node = path[i];
+
+        if (child == nullptr && i > 0 && !node->isWordEnd && node->children.size() == 1)
+            continue;
+
+        Node *parent = new Node(*node);
+        const size_t position = parent->position(key);
+
+        if (child == nullptr) {
+            parent->keys.erase(parent->keys.begin() + position);
+            parent->children.erase(parent->children.begin() + position);
+        } else {
+            parent->children[position] = child;
+        }
+
+        child = parent;
+    }
+
+    publish(child, word, path);
+    m_size.fetch_sub(1, std::memory_order_relaxed);
+
+    return true;
+}
+
+template <typename TString>
+std::vector<TString> ConcurrentPrefixTree<TString>::query(const string_type &prefix) const {
+    if (prefix.empty())
+        return {};
+
+    ReadGuard guard(*this);
+    const Node *node = m_root.load();
+
+    for (const symbol_type symbol : prefix) {
+        node = node->findChild(static_cast<key_type>(symbol));
+
+        if (node == nullptr)
+            return {};
+    }
+
+    std::vector<string_type> result;
+    string_type buffer = prefix;
+
+    collect(node, buffer, result);
+
+    return result;
+}
+
+template <typename TString>
+void ConcurrentPrefixTree<TString>::findPath(const string_type &word,
+                                             std::vector<const Node *> &path) const {
+    const Node *node = m_root.load(std::memory_order_relaxed);
+
+    path.push_back(node);
+
+    for (const symbol_type symbol : word) {
+        node = node->findChild(static_cast<key_type>(symbol));
+
+        if (node == nullptr)
+            break;
+
+        path.push_back(node);
+    }
+}
+
+template <typename TString>
+void ConcurrentPrefixTree<TString>::publish(const Node *root, const string_type &word,
+                                            const std::vector<const Node *> &retired) {
+    // The new nodes are the ones along the word, up to where it leaves the new version
+    const Node *node = root;
+    size_t created = root->memoryUsage();
+
+    for (size_t i = 0; i < word.size(); ++i) {
+        node = node->findChild(static_cast<key_type>(word[i]));
+
+        if (node == nullptr)
+            break;
+
+        created += node->memoryUsage();
+    }
+
+    m_memoryUsage.fetch_add(created, std::memory_order_relaxed);
+    m_root.store(root);
+    m_retired.emplace_back(m_epoch.fetch_add(1), retired);
+    reclaim();
+}
+
+template <typename TString> void ConcurrentPrefixTree<TString>::reclaim() {
+    uint64_t oldestEpoch = std::numeric_limits<uint64_t>::max();
+
+    for (const auto &reader : m_readers) {
+        const uint64_t epoch = reader.epoch.load();
+
+        if (epoch != 0)
+            oldestEpoch = std::min(oldestEpoch, epoch);
+    }
+
+    // Batches are in increasing order of epoch
+    auto it = m_retired.begin();
+
+    for (; it != m_retired.end() && it->first < oldestEpoch; ++it) {
+        for (const Node *node : it->second) {
+            m_memoryUsage.fetch_sub(node->memoryUsage(), std::memory_order_relaxed);
+            delete node;
+        }
+    }
+
+    m_retired.erase(m_retired.begin(), it);
+}
+
+template <typename TString>
+void ConcurrentPrefixTree<TString>::collect(const Node *node, string_type &buffer,
+                                            std::vector<string_type> &result) {
+    if (node->isWordEnd)
+        result.push_back(buffer);
+
+    for (size_t i = 0; i < node->keys.size(); ++i) {
+        buffer.push_back(static_cast<symbol_type>(node->keys[i]));
+        collect(node->children[i], buffer, result);
+        buffer.pop_back();
+    }
+}
+
+template <typename TString> void ConcurrentPrefixTree<TString>::destroyTree(const Node *node) {
+    std::vector<const Node *> pending{node};
+
+    while (!pending.empty()) {
+        const Node *current = pending.back();
+
+        pending.pop_back();
+        pending.insert(pending.end(), current->children.begin(), current->children.end());
+        delete current;
+    }
+}
+
+} // namespace cake
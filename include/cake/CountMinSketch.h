@@ -22,54 +22,129 @@
  * SOFTWARE.
  */
 
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <vector>
 
+#include <cake/Hash.h>
+
 namespace cake {
-    class CountMinSketch {
-        public:
-            CountMinSketch(size_t expectedNumElements) {
-                // TODO initialize the cells
-            }
-
-            template <typename TElement>
-            void increment(const TElement& element) {
-                const auto idxs = computeElementIndices(element);
-
-                for(size_t i = 0; i < idxs.size(); ++i) {
-                    m_counts[i][idxs[i]]++;
-                }
-            }
-
-            template <typename TElement>
-            size_t count(const TElement& element) const {
-                size_t estimateCount = std::numeric_limits<size_t>::max();
-                const auto idxs = computeElementIndices(element);
-
-                for(size_t i = 0; i < idxs.size(); ++i) {
-                    const size_t count = m_counts[i][idxs[i]];
-
-                    if(estimateCount > count) estimateCount = count;
-                }
-
-                return estimateCount;
-            }
-
-        private:
-            template <typename TElement>
-            std::vector<size_t> computeElementIndices(const TElement& element) const {
-                std::vector<size_t> idxs;
-                const size_t numCols = m_counts.back().size();
-
-                for(int i = 0; i < m_counts.size(); ++i) {
-                    const size_t idx = Hash::murmur64A(element, numCols * i) % numCols;
-                    idxs.push_back(idx);
-                }
-
-                return idxs;
-            }
-
-        private:
-            std::vector<std::vector<size_t>> m_counts;
-    };
-}
\ No newline at end of file
+
+/**
+ * Count-Min Sketch data structure. Estimates the frequency of elements in a stream
+ * using a fixed amount of memory. Estimates never undercount, but may overcount due to
+ * hash collisions.
+ *
+ * Counters saturate instead of overflowing, and can be aged with halve(), which makes the
+ * sketch suitable as a frequency histogram of recent history (e.g. for cache admission).
+ */
+class CountMinSketch {
+  public:
+    using counter_type = uint32_t;
+
+    static constexpr size_t numRows = 4;
+
+    /**
+     * Constructor.
+     *
+     * @param expectedNumElements Number of expected distinct elements. The width of each
+     * row is the next power of two not smaller than this value (with a minimum of 16).
+     */
+    explicit CountMinSketch(size_t expectedNumElements);
+
+    /**
+     * Returns the number of counters in each row of the sketch.
+     */
+    size_t width() const { return m_width; }
+
+    /**
+     * Returns the memory used by the sketch, including all its counters.
+     *
+     * @return The number of bytes.
+     */
+    size_t memoryUsage() const {
+        return sizeof(*this) + m_counts.capacity() * sizeof(counter_type);
+    }
+
+    /**
+     * Increments the count of a given element.
+     *
+     * @param element The given element.
+     */
+    template <typename TElement> void increment(const TElement &element);
+
+    /**
+     * Estimates the count of a given element.
+     *
+     * @param element The given element.
+     *
+     * @return An estimate never smaller than the number of times the element was incremented
+     * since the sketch was last cleared (or halved).
+     */
+    template <typename TElement> size_t count(const TElement &element) const;
+
+    /**
+     * Halves all the counters. Used to age the sketch so that it reflects recent history.
+     */
+    void halve();
+
+    /**
+     * Sets all the counters to zero.
+     */
+    void clear();
+
+  private:
+    /**
+     * Given an element, computes the index of its counter on every row.
+     *
+     * @param element The given element.
+     *
+     * @return The indices of the element, one per row, into m_counts.
+     */
+    template <typename TElement>
+    std::array<size_t, numRows> computeElementIndices(const TElement &element) const;
+
+  private:
+    size_t m_width;
+    std::vector<counter_type> m_counts; /// numRows rows of m_width counters, row-major
+};
+
+template <typename TElement>
+std::array<size_t, CountMinSketch::numRows>
+CountMinSketch::computeElementIndices(const TElement &element) const {
+    // A single 64-bit hash is split in two and combined as h1 + i * h2 to derive the
+    // index on each row (Kirsch-Mitzenmacher), instead of hashing once per row.
+    const uint64_t hash = Hash::murmur64A(element, m_width);
+    const uint64_t h1 = hash & 0xffffffff;
+    const uint64_t h2 = (hash >> 32) | 1;
+    std::array<size_t, numRows> idxs;
+
+    for (size_t i = 0; i < numRows; ++i) {
+        idxs[i] = i * m_width + ((h1 + i * h2) & (m_width - 1));
+    }
+
+    return idxs;
+}
+
+template <typename TElement> void CountMinSketch::increment(const TElement &element) {
+    for (const auto idx : computeElementIndices(element)) {
+        if (m_counts[idx] != std::numeric_limits<counter_type>::max())
+            ++m_counts[idx];
+    }
+}
+
+template <typename TElement> size_t CountMinSketch::count(const TElement &element) const {
+    counter_type estimateCount = std::numeric_limits<counter_type>::max();
+
+    for (const auto idx : computeElementIndices(element)) {
+        estimateCount = std::min(estimateCount, m_counts[idx]);
+    }
+
+    return estimateCount;
+}
+} // namespace cake
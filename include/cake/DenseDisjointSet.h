@@ -0,0 +1,200 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cake {
+
+/**
+ * Disjoint Set of dense integer elements 0, 1, ..., size() - 1. A single array indexed by
+ * element holds the parent of every element. For the root of a set, which represents it, the
+ * array holds minus the size of the set. Elements are not hashed, and each one takes as much
+ * memory as its type. find halves the paths it walks, and join links the smaller set under
+ * the larger one.
+ */
+template <typename TElement> class DenseDisjointSet {
+    static_assert(std::is_integral_v<TElement> && std::is_signed_v<TElement>,
+                  "Elements must be of a signed integer type");
+
+  public:
+    using element_type = TElement;
+
+    /**
+     * Constructor. Creates a disjoint set with a given number of elements, each in its own
+     * set.
+     *
+     * @param numElements Number of elements.
+     */
+    explicit DenseDisjointSet(size_t numElements = 0);
+
+    /**
+     * Reserves memory for a given number of elements, so that the set does not reallocate
+     * while it grows up to it.
+     *
+     * @param numElements Number of elements.
+     */
+    void reserve(size_t numElements) { m_entries.reserve(numElements); }
+
+    /**
+     * Returns the number of elements.
+     *
+     * @return The number of elements.
+     */
+    size_t size() const { return m_entries.size(); }
+
+    /**
+     * Returns the number of disjoint sets.
+     *
+     * @return The number of sets.
+     */
+    size_t numSets() const { return m_numSets; }
+
+    /**
+     * Adds a new element in its own set.
+     *
+     * @return The new element, which is the previous size().
+     */
+    element_type add();
+
+    /**
+     * Finds the representative of the set of an element, halving the path to it.
+     *
+     * @param element The element. Elements that were not added yet are in sets of their own.
+     * @return The representative of the set.
+     */
+    element_type find(element_type element);
+
+    /**
+     * Merges the sets of two elements. The set does not grow to fit them: add elements or
+     * construct the set with enough of them first.
+     *
+     * @param element1 The first element.
+     * @param element2 The second element.
+     * @return true, if a merge took place; false, if the elements were already in the same
+     *         set, or any of them is out of range.
+     */
+    bool join(element_type element1, element_type element2);
+
+    /**
+     * Tests whether two elements are in the same set.
+     *
+     * @param element1 The first element.
+     * @param element2 The second element.
+     * @return true, if the elements are in the same set; false, otherwise.
+     */
+    bool sameSet(element_type element1, element_type element2) {
+        return find(element1) == find(element2);
+    }
+
+    /**
+     * Returns the size of the set of an element.
+     *
+     * @param element The element.
+     * @return The number of elements in the set.
+     */
+    size_t setSize(element_type element);
+
+    /**
+     * Returns the memory used by the disjoint set.
+     *
+     * @return The number of bytes.
+     */
+    size_t memoryUsage() const {
+        return sizeof(*this) + m_entries.capacity() * sizeof(element_type);
+    }
+
+  private:
+    bool contains(element_type element) const {
+        return element >= 0 && static_cast<size_t>(element) < m_entries.size();
+    }
+
+    std::vector<element_type> m_entries; /// Parent of every element, or minus its set size
+    size_t m_numSets;
+};
+
+template <typename TElement>
+DenseDisjointSet<TElement>::DenseDisjointSet(size_t numElements)
+    : m_entries(numElements, -1), m_numSets(numElements) {}
+
+template <typename TElement> TElement DenseDisjointSet<TElement>::add() {
+    m_entries.push_back(-1);
+    ++m_numSets;
+
+    return static_cast<element_type>(m_entries.size() - 1);
+}
+
+template <typename TElement> TElement DenseDisjointSet<TElement>::find(element_type element) {
+    if (!contains(element))
+        return element;
+
+    element_type parent;
+
+    while ((parent = m_entries[element]) >= 0) {
+        const element_type grandparent = m_entries[parent];
+
+        if (grandparent < 0)
+            return parent;
+
+        m_entries[element] = grandparent;
+        element = grandparent;
+    }
+
+    return element;
+}
+
+template <typename TElement>
+bool DenseDisjointSet<TElement>::join(element_type element1, element_type element2) {
+    if (!contains(element1) || !contains(element2))
+        return false;
+
+    element_type root1 = find(element1);
+    element_type root2 = find(element2);
+
+    if (root1 == root2)
+        return false;
+
+    // Sizes are negative, so the larger set has the smaller entry
+    if (m_entries[root1] > m_entries[root2])
+        std::swap(root1, root2);
+
+    m_entries[root1] += m_entries[root2];
+    m_entries[root2] = root1;
+    --m_numSets;
+
+    return true;
+}
+
+template <typename TElement> size_t DenseDisjointSet<TElement>::setSize(element_type element) {
+    if (!contains(element))
+        return 1;
+
+    return static_cast<size_t>(-m_entries[find(element)]);
+}
+
+} // namespace cake
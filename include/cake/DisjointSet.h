@@ -24,10 +24,14 @@
 
 #pragma once
 
+#include <cstddef>
+#include <limits>
 #include <optional>
 #include <unordered_map>
 #include <vector>
 
+#include <cake/MemoryUsage.h>
+
 namespace cake {
 /**
  * Disjoint Set data structure. Maintains a collection of disjoint sets, and
@@ -60,6 +64,27 @@ template <typename TElement> class DisjointSet {
         friend class std::optional<SetHandle>;
     };
 
+    /**
+     * Grouping of the elements by set, in compressed form. The members of the i-th set are
+     * members[offsets[i]], ..., members[offsets[i + 1] - 1], and its handle is handles[i].
+     */
+    struct Components {
+        std::vector<size_t> offsets; /// One per set, plus the total number of elements
+        std::vector<element_type> members;
+        std::vector<SetHandle> handles;
+
+        /** Returns the number of sets. */
+        size_t size() const { return handles.size(); }
+    };
+
+    /**
+     * Reserves memory for a given number of elements, so that adding up to that many does
+     * not reallocate.
+     *
+     * @param numElements Number of elements.
+     */
+    void reserve(size_t numElements);
+
     /**
      * Creates a new disjoint set with a single element. If the element
      * is already present in any of the sets, no new set is created.
@@ -103,22 +128,76 @@ template <typename TElement> class DisjointSet {
      */
     bool join(const SetHandle &handle1, const SetHandle &handle2);
 
+    /**
+     * Merges the sets of the two elements of every edge in a range, adding the elements that
+     * are not present yet, as join does.
+     *
+     * @param edges Range of pairs of elements.
+     * @return The number of merges that took place.
+     */
+    template <typename TRange> size_t joinAll(const TRange &edges);
+
+    /**
+     * Returns the number of disjoint sets. It takes constant time.
+     *
+     * @return The number of sets.
+     */
+    size_t numSets() const { return m_numSets; }
+
+    /**
+     * Returns the number of elements of a set. It takes constant time for the handles
+     * returned by find, and otherwise follows the handle to the set it was merged into.
+     *
+     * @param handle The handle of the set.
+     * @return The number of elements, or 0 if the handle is invalid.
+     */
+    size_t setSize(const SetHandle &handle) const;
+
+    /**
+     * Groups all the elements by set, in a single pass over them.
+     *
+     * @return The sets and their members. Sets and members are in no particular order.
+     */
+    Components components() const;
+
+    /**
+     * Returns an estimate of the memory used by the disjoint set: the set object, its arrays
+     * and its hash table. Memory owned by the elements themselves is not counted.
+     *
+     * @return The number of bytes.
+     */
+    size_t memoryUsage() const {
+        using MapValue = typename decltype(m_elementToIdx)::value_type;
+
+        return sizeof(*this) + m_setSizes.capacity() * sizeof(size_t) +
+               m_ownerSetHandles.capacity() * sizeof(SetHandle) +
+               m_elementToIdx.bucket_count() * MemoryUsage::hashBucket +
+               m_elementToIdx.size() * MemoryUsage::hashNode<MapValue>;
+    }
+
   private:
+    /**
+     * Finds the index of the root of the set of an index, halving the path to it.
+     */
+    size_t rootIdx(size_t idx) const;
+
     std::vector<size_t> m_setSizes;
     mutable std::vector<SetHandle> m_ownerSetHandles;
     std::unordered_map<element_type, size_t> m_elementToIdx; /// Element to idx in above containers
+    size_t m_numSets = 0;
 };
 
 template <typename TElement>
 typename DisjointSet<TElement>::SetHandle DisjointSet<TElement>::add(const element_type &element) {
-    const auto setHandle = find(element);
+    // A single lookup, whether the element is present or not
+    const auto [it, inserted] = m_elementToIdx.try_emplace(element, m_ownerSetHandles.size());
 
-    if (setHandle)
-        return setHandle.value();
+    if (!inserted)
+        return SetHandle(rootIdx(it->second));
 
-    size_t idx = m_ownerSetHandles.size();
-    m_elementToIdx.insert({element, idx});
+    size_t idx = it->second;
     m_setSizes.push_back(1);
+    ++m_numSets;
 
     SetHandle newSetHandle(idx);
     m_ownerSetHandles.push_back(newSetHandle);
@@ -134,13 +213,7 @@ DisjointSet<TElement>::find(const element_type &element) const {
     if (it == m_elementToIdx.end())
         return {};
 
-    size_t idx = it->second;
-    while (idx != m_ownerSetHandles[idx].value) {
-        m_ownerSetHandles[idx] = m_ownerSetHandles[m_ownerSetHandles[idx].value];
-        idx = m_ownerSetHandles[idx].value;
-    }
-
-    return std::optional<SetHandle>(SetHandle(idx));
+    return std::optional<SetHandle>(SetHandle(rootIdx(it->second)));
 }
 
 template <typename TElement>
@@ -174,7 +247,74 @@ bool DisjointSet<TElement>::join(const SetHandle &handle1, const SetHandle &hand
     m_ownerSetHandles[smallSetIdx].value = largeSetIdx;
     m_setSizes[largeSetIdx] += m_setSizes[smallSetIdx];
     m_setSizes[smallSetIdx] = 0;
+    --m_numSets;
 
     return true;
 }
+
+template <typename TElement> void DisjointSet<TElement>::reserve(size_t numElements) {
+    m_setSizes.reserve(numElements);
+    m_ownerSetHandles.reserve(numElements);
+    m_elementToIdx.reserve(numElements);
+}
+
+template <typename TElement>
+template <typename TRange>
+size_t DisjointSet<TElement>::joinAll(const TRange &edges) {
+    size_t numMerges = 0;
+
+    for (const auto &[element1, element2] : edges)
+        numMerges += join(element1, element2);
+
+    return numMerges;
+}
+
+template <typename TElement> size_t DisjointSet<TElement>::setSize(const SetHandle &handle) const {
+    if (handle.value >= m_ownerSetHandles.size())
+        return 0;
+
+    return m_setSizes[rootIdx(handle.value)];
+}
+
+template <typename TElement>
+typename DisjointSet<TElement>::Components DisjointSet<TElement>::components() const {
+    constexpr size_t noPosition = std::numeric_limits<size_t>::max();
+
+    Components result;
+    // Position of the next member of every set, by index of its root
+    std::vector<size_t> nextPosition(m_ownerSetHandles.size(), noPosition);
+
+    result.offsets.reserve(m_numSets + 1);
+    result.handles.reserve(m_numSets);
+    result.members.resize(m_elementToIdx.size());
+
+    size_t numAssigned = 0;
+
+    // The sizes of the sets are known, so every set gets its range when first seen
+    for (const auto &[element, idx] : m_elementToIdx) {
+        const size_t root = rootIdx(idx);
+
+        if (nextPosition[root] == noPosition) {
+            nextPosition[root] = numAssigned;
+            result.offsets.push_back(numAssigned);
+            result.handles.push_back(SetHandle(root));
+            numAssigned += m_setSizes[root];
+        }
+
+        result.members[nextPosition[root]++] = element;
+    }
+
+    result.offsets.push_back(numAssigned);
+
+    return result;
+}
+
+template <typename TElement> size_t DisjointSet<TElement>::rootIdx(size_t idx) const {
+    while (idx != m_ownerSetHandles[idx].value) {
+        m_ownerSetHandles[idx] = m_ownerSetHandles[m_ownerSetHandles[idx].value];
+        idx = m_ownerSetHandles[idx].value;
+    }
+
+    return idx;
+}
 } // namespace cake
\ No newline at end of file
@@ -24,14 +24,84 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 
+#include <cake/Simd.h>
+
 namespace cake {
 namespace Hash {
 
+/// Multiplier of MurmurHash64A
+constexpr uint64_t murmurMultiplier = 0xc6a4a7935bd1e995ULL;
+
+/// Shift of MurmurHash64A
+constexpr int murmurShift = 47;
+
+/**
+ * Mixes a block of 8 bytes as MurmurHash64A does, before combining it with the hash. The
+ * result does not depend on the seed.
+ *
+ * @param bytes Pointer to the block, which does not need to be aligned.
+ *
+ * @return The mixed block.
+ */
+inline uint64_t murmurBlock(const unsigned char *bytes) {
+    uint64_t k;
+
+    // Unaligned load, in native byte order as in the reference implementation
+    std::memcpy(&k, bytes, sizeof(k));
+
+    k *= murmurMultiplier;
+    k ^= k >> murmurShift;
+
+    return k * murmurMultiplier;
+}
+
 /**
- * Computes 64bit MurmurHash2 of given data.
+ * Gathers the last bytes of the data, those after the last full block, as MurmurHash64A does.
+ *
+ * @param bytes Pointer to the last bytes.
+ * @param numBytes Number of bytes, less than 8.
+ *
+ * @return The bytes, in little-endian order.
+ */
+inline uint64_t murmurTail(const unsigned char *bytes, size_t numBytes) {
+    uint64_t tail = 0;
+
+    switch (numBytes) {
+    case 7:
+        tail ^= uint64_t(bytes[6]) << 48;
+        [[fallthrough]];
+    case 6:
+        tail ^= uint64_t(bytes[5]) << 40;
+        [[fallthrough]];
+    case 5:
+        tail ^= uint64_t(bytes[4]) << 32;
+        [[fallthrough]];
+    case 4:
+        tail ^= uint64_t(bytes[3]) << 24;
+        [[fallthrough]];
+    case 3:
+        tail ^= uint64_t(bytes[2]) << 16;
+        [[fallthrough]];
+    case 2:
+        tail ^= uint64_t(bytes[1]) << 8;
+        [[fallthrough]];
+    case 1:
+        tail ^= uint64_t(bytes[0]);
+    };
+
+    return tail;
+}
+
+/**
+ * Computes 64bit MurmurHash2 of given data. It is defined in the header, so that it can be
+ * inlined into the hot paths that hash, such as the probes of BloomFilter, whatever the type
+ * of the cake library.
  *
  * @param data Pointer to data.
  * @param sizeInBytes Size in bytes of data.
@@ -39,7 +109,28 @@ namespace Hash {
  *
  * @return 64 bit hash.
  */
-uint64_t murmur64A(const void *data, size_t sizeInBytes, uint64_t seed);
+inline uint64_t murmur64A(const void *data, size_t sizeInBytes, uint64_t seed) {
+    // MurmurHash64A, written by Austin Appleby and placed in the public domain
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    const unsigned char *end = bytes + sizeInBytes / 8 * 8;
+    uint64_t h = seed ^ (sizeInBytes * murmurMultiplier);
+
+    for (; bytes != end; bytes += 8) {
+        h ^= murmurBlock(bytes);
+        h *= murmurMultiplier;
+    }
+
+    if (sizeInBytes % 8 != 0) {
+        h ^= murmurTail(bytes, sizeInBytes % 8);
+        h *= murmurMultiplier;
+    }
+
+    h ^= h >> murmurShift;
+    h *= murmurMultiplier;
+    h ^= h >> murmurShift;
+
+    return h;
+}
 
 /**
  * Computes 64bit MurmurHash2 of a given object. The object must be of fundamental type.
@@ -80,5 +171,49 @@ template <typename TElement,
 uint64_t murmur64A(const std::vector<TElement> &vec, uint64_t seed) {
     return murmur64A(vec.data(), vec.size() * sizeof(TElement), seed);
 }
+
+/**
+ * Computes 64bit MurmurHash2 of a given object with several seeds, with the vectorized kernel
+ * of Simd::murmur64A. The object must be of fundamental type.
+ *
+ * @param object Given object.
+ * @param seeds Pointer to the seeds.
+ * @param hashes Pointer to where the hash for every seed is written.
+ * @param numSeeds Number of seeds.
+ */
+template <typename TObject,
+          typename std::enable_if_t<std::is_fundamental<TObject>::value, int> = 0>
+void murmur64A(const TObject object, const uint64_t *seeds, uint64_t *hashes, size_t numSeeds) {
+    Simd::murmur64A(&object, sizeof(TObject), seeds, hashes, numSeeds);
+}
+
+/**
+ * Computes 64bit MurmurHash2 of a given string with several seeds.
+ *
+ * @param str Reference to string.
+ * @param seeds Pointer to the seeds.
+ * @param hashes Pointer to where the hash for every seed is written.
+ * @param numSeeds Number of seeds.
+ */
+template <typename TChar>
+void murmur64A(const std::basic_string<TChar> &str, const uint64_t *seeds, uint64_t *hashes,
+               size_t numSeeds) {
+    Simd::murmur64A(str.data(), str.size() * sizeof(TChar), seeds, hashes, numSeeds);
+}
+
+/**
+ * Computes 64bit MurmurHash2 of a vector of objects of fundamental type with several seeds.
+ *
+ * @param vec Reference to vector.
+ * @param seeds Pointer to the seeds.
+ * @param hashes Pointer to where the hash for every seed is written.
+ * @param numSeeds Number of seeds.
+ */
+template <typename TElement,
+          typename std::enable_if_t<std::is_fundamental<TElement>::value, int> = 0>
+void murmur64A(const std::vector<TElement> &vec, const uint64_t *seeds, uint64_t *hashes,
+               size_t numSeeds) {
+    Simd::murmur64A(vec.data(), vec.size() * sizeof(TElement), seeds, hashes, numSeeds);
+}
 } // namespace Hash
 } // namespace cake
\ No newline at end of file
@@ -24,36 +24,119 @@
 
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <list>
 #include <map>
+#include <memory>
 #include <utility>
+#include <vector>
+
+#include <cake/CacheSnapshot.h>
+#include <cake/CacheStats.h>
+#include <cake/MemoryUsage.h>
+#include <cake/TimerWheel.h>
 
 namespace cake {
 
+/**
+ * Default weigher of LRUCache. Every entry weighs one, so the capacity of the cache is
+ * a number of entries.
+ */
+struct UnitWeigher {
+    template <class TKey, class TValue> size_t operator()(const TKey &, const TValue &) const {
+        return 1;
+    }
+};
+
 /**
  * LRU Cache data structure. The cache keeps a fixed size set of values that can
  * be retrieved through their associated keys. If the cache is full, every time
  * a new entry is inserted, the least recently used entry is removed from the cache
  * to leave space for the new entry.
+ *
+ * By default the capacity is a number of entries. Given a weigher, a functor that maps
+ * a key and a value to a cost (e.g. size in bytes), the capacity is a total weight instead,
+ * and as many least recently used entries as needed are evicted to fit a new one. Entries
+ * are weighed when inserted; modifying a value in place does not update its weight.
+ *
+ * Entries may also have a time to live, either per entry or a default one. The cache keeps
+ * the last time it read from the clock, in milliseconds, which it reads only when it needs
+ * to: when an entry with a time to live is inserted, so that deadlines are measured from the
+ * actual time of insertion, and when a lookup finds an entry whose deadline has not passed
+ * at the last time read. Lookups of entries without a time to live never read the clock, and
+ * lookups never return an expired entry, however long the cache was idle. Expired entries are
+ * treated as missing, and expire() removes all of them in bulk through a timer wheel.
+ *
+ * With CacheStatsRecorder as its statistics policy, the cache counts hits, misses, inserts
+ * and removals by cause, and samples access latencies. The default policy, NoCacheStats,
+ * takes no space and records nothing. See CacheStats.
+ *
+ * The contents of the cache can be saved to a snapshot and loaded back, preserving their
+ * recency order, to warm up a cache after a restart. See CacheSnapshot.
  */
-template <class TKey, class TValue> class LRUCache {
+template <class TKey, class TValue, class TWeigher = UnitWeigher, class TStats = NoCacheStats,
+          class TClock = std::chrono::steady_clock>
+class LRUCache {
   public:
     using key_type = TKey;
     using value_type = TValue;
+    using weigher_type = TWeigher;
+    using stats_type = TStats;
+    using clock_type = TClock;
+    using time_point = typename clock_type::time_point;
+    using duration = typename clock_type::duration;
 
   private:
-    using KeyValuePair = std::pair<key_type, value_type>;
+    using Timer = typename TimerWheel<key_type>::Handle;
+
+    struct Entry {
+        key_type key;
+        value_type value;
+        size_t weight;
+        uint64_t deadline; /// Expiration tick, or zero if the entry does not expire
+        Timer timer;
+    };
+
+    using EntryList = std::list<Entry>;
 
   public:
     /**
-     * Constructor. If given maximum size is zero, an exception is thrown.
+     * Constructor. A maximum size of zero is converted to one.
      *
-     * @param maxSize Maximum size allowed.
+     * @param maxSize Maximum size allowed, as a number of entries or as a total weight
+     * when a weigher is used.
+     * @param weigher Functor computing the weight of an entry.
+     */
+    explicit LRUCache(size_t maxSize, weigher_type weigher = weigher_type());
+
+    /**
+     * Copy constructor. The copy has the same entries, in the same order and with the same
+     * deadlines, and statistics of its own.
+     */
+    LRUCache(const LRUCache &other);
+
+    /**
+     * Copy assignment. Same as the copy constructor, except that statistics are kept.
+     */
+    LRUCache &operator=(const LRUCache &other);
+
+    /**
+     * Move constructor. The cache takes the entries of the other one, which is left empty,
+     * and has statistics of its own.
+     */
+    LRUCache(LRUCache &&other) noexcept;
+
+    /**
+     * Move assignment. Same as the move constructor, except that statistics are kept.
      */
-    explicit LRUCache(size_t maxSize);
+    LRUCache &operator=(LRUCache &&other) noexcept;
 
     /**
-     * Returns the maximum number of entries allowed in the cache.
+     * Returns the maximum number of entries (or maximum total weight) allowed in the cache.
      *
      * @return Maximum size allowed.
      */
@@ -66,10 +149,34 @@ template <class TKey, class TValue> class LRUCache {
      */
     size_t size() const { return m_size; }
 
+    /**
+     * Returns the total weight of the entries currently in the cache. Without a weigher,
+     * this is the same as size().
+     *
+     * @return Current weight.
+     */
+    size_t currentWeight() const { return m_weight; }
+
+    /**
+     * Returns an estimate of the memory used by the cache: the cache object, the list node
+     * and the map node of every entry, and the timer wheel, if any. Memory owned by the keys
+     * and values themselves is not counted. It takes constant time.
+     *
+     * @return The number of bytes.
+     */
+    size_t memoryUsage() const {
+        using MapValue = typename decltype(m_cache)::value_type;
+
+        return sizeof(*this) +
+               m_cache.size() * (MemoryUsage::listNode<Entry> + MemoryUsage::treeNode<MapValue>) +
+               (m_timerWheel ? m_timerWheel->memoryUsage() : 0);
+    }
+
     /**
      * Returns a reference to the entry with the given key. This operations touches
      * the entry, so it makes it the most recently used entry.
-     * If the entry does not exist, one is created.
+     * If the entry does not exist, one is created. A created entry is always admitted,
+     * even if it alone is heavier than the maximum size.
      *
      * @param key The given key,
      *
@@ -80,11 +187,60 @@ template <class TKey, class TValue> class LRUCache {
     /**
      * Insert a new entry into the cache. This operations touches
      * the entry, so it makes it the most recently used entry.
+     * An entry heavier than the maximum size is not admitted, and any previous
+     * entry with the same key is removed.
      *
      * @param key The given key
      * @param value The given value
+     *
+     * @return true if the entry was admitted into the cache, false otherwise.
+     */
+    bool insert(const key_type &key, const value_type &value);
+
+    /**
+     * Insert a new entry into the cache with a given time to live. Otherwise, the same
+     * as insert(key, value).
+     *
+     * @param key The given key
+     * @param value The given value
+     * @param timeToLive Time after which the entry expires. Zero means it never expires.
+     *
+     * @return true if the entry was admitted into the cache, false otherwise.
+     */
+    bool insert(const key_type &key, const value_type &value, duration timeToLive);
+
+    /**
+     * Returns the time to live given to entries inserted without an explicit one.
+     *
+     * @return Default time to live. Zero means that entries do not expire.
+     */
+    duration defaultTimeToLive() const { return m_defaultTimeToLive; }
+
+    /**
+     * Sets the time to live given to entries inserted without an explicit one. Entries
+     * already in the cache are not affected.
+     *
+     * @param timeToLive Default time to live. Zero means that entries do not expire.
+     */
+    void setDefaultTimeToLive(duration timeToLive) { m_defaultTimeToLive = timeToLive; }
+
+    /**
+     * Advances the current time of the cache and removes all the entries that expired.
+     * Times earlier than the current time of the cache are ignored.
+     *
+     * @param now The new current time.
+     */
+    void expire(time_point now = clock_type::now());
+
+    /**
+     * Returns the last time the cache read from the clock, against which deadlines are
+     * checked.
+     *
+     * @return The current time, truncated to milliseconds.
      */
-    void insert(const key_type &key, const value_type &value);
+    time_point now() const {
+        return time_point(std::chrono::duration_cast<duration>(std::chrono::milliseconds(m_now)));
+    }
 
     /**
      * Checks if there is an entry with the given key. This operations touches
@@ -98,7 +254,18 @@ template <class TKey, class TValue> class LRUCache {
     bool contains(const key_type &key);
 
     /**
-     * Checks if there is an entry with the given key.
+     * Looks up the entry with the given key. This operations touches
+     * the entry, so it makes it the most recently used entry.
+     *
+     * @param key The given key
+     *
+     * @return A pointer to the associated value, or nullptr if there is no entry in the
+     * cache with the given key. The pointer is valid until the entry is removed.
+     */
+    value_type *find(const key_type &key);
+
+    /**
+     * Removes the entry with the given key.
      *
      * @param key The given key
      *
@@ -107,14 +274,142 @@ template <class TKey, class TValue> class LRUCache {
      */
     bool remove(const key_type &key);
 
+    /**
+     * Returns a snapshot of the statistics of the cache. It is safe to call it from a thread
+     * other than the one using the cache. With NoCacheStats, all values are zero.
+     *
+     * @return The statistics.
+     */
+    CacheStats stats() const { return m_stats.snapshot(); }
+
+    /**
+     * Inserts a new entry as the least recently used one, but only if it fits without
+     * evicting other entries and there is no entry with the same key. Used to fill a cache
+     * from a snapshot.
+     *
+     * @param key The given key
+     * @param value The given value
+     *
+     * @return true if the entry was admitted into the cache, false otherwise.
+     */
+    bool append(const key_type &key, const value_type &value);
+
+    /**
+     * Returns a copy of all the entries, without touching them.
+     *
+     * @return Key-value pairs, from the most to the least recently used.
+     */
+    std::vector<std::pair<key_type, value_type>> entries() const;
+
+    /**
+     * Writes the entries of the cache to a snapshot. Times to live are not saved. To keep the
+     * cache available while a large snapshot is written, copy the entries with entries() and
+     * write them from another thread with CacheSnapshot::write.
+     *
+     * @param output Stream the snapshot is written to.
+     *
+     * @return true if the snapshot was written successfully.
+     */
+    template <typename TKeySerializer = Serializer<key_type>,
+              typename TValueSerializer = Serializer<value_type>>
+    bool saveSnapshot(std::ostream &output) const {
+        return CacheSnapshot::write<key_type, value_type, TKeySerializer, TValueSerializer>(
+            output, entries());
+    }
+
+    /**
+     * Reads entries from a snapshot, and appends them to the cache as less recently used than
+     * the entries already in it, until the cache is full. Their relative recency order is
+     * preserved, so a smaller cache keeps the most recently used ones. Loaded entries get
+     * the default time to live.
+     *
+     * @param input Stream the snapshot is read from.
+     *
+     * @return true if the snapshot was valid, false otherwise. Entries read before an error
+     * are kept.
+     */
+    template <typename TKeySerializer = Serializer<key_type>,
+              typename TValueSerializer = Serializer<value_type>>
+    bool loadSnapshot(std::istream &input) {
+        return CacheSnapshot::read<key_type, value_type, TKeySerializer, TValueSerializer>(
+            input, [this](const key_type &key, const value_type &value) {
+                append(key, value);
+                return m_weight < m_maxSize;
+            });
+    }
+
   private:
+    /**
+     * Converts a time point into a tick of the timer wheel.
+     */
+    static uint64_t toTick(time_point time) {
+        const auto sinceEpoch = time.time_since_epoch();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(sinceEpoch).count();
+    }
+
+    /**
+     * Refreshes the last time read from the clock.
+     */
+    void refreshClock() { m_now = std::max(m_now, toTick(clock_type::now())); }
+
+    /**
+     * Points the map and the timer wheel, if any, to the entries copied from another cache.
+     */
+    void rebuildIndex(const LRUCache &other);
+
+    /**
+     * Returns whether the entry to which a given iterator points has expired. The clock is
+     * only read when the entry has a deadline that had not passed at the last time read.
+     */
+    bool isExpired(typename EntryList::const_iterator it) {
+        if (it->deadline == 0)
+            return false;
+
+        if (it->deadline > m_now)
+            refreshClock();
+
+        return it->deadline <= m_now;
+    }
+
+    /**
+     * Leaves a cache whose contents were moved out empty.
+     */
+    static void resetMovedFrom(LRUCache &other);
+
     /**
      * Updates the cache such that the entry to which a given iterator becomes
      * the most recently used entry.
      * 
      * @param it A given iterator. 
      */
-    void touchEntry(typename std::list<KeyValuePair>::iterator &it);
+    void touchEntry(typename EntryList::iterator it);
+
+    /**
+     * Adds a new entry as the most recently used one, evicting least recently used
+     * entries until it fits. There must be no entry with the same key in the cache.
+     *
+     * @param key The given key
+     * @param value The given value
+     * @param weight The weight of the entry
+     * @param timeToLive Time to live of the entry. Zero means it never expires.
+     */
+    void admitEntry(const key_type &key, const value_type &value, size_t weight,
+                    duration timeToLive);
+
+    /**
+     * Schedules the expiration of the entry to which a given iterator points.
+     *
+     * @param it A given iterator.
+     * @param timeToLive Time to live of the entry. Zero means it never expires.
+     */
+    void scheduleExpiration(typename EntryList::iterator it, duration timeToLive);
+
+    /**
+     * Removes the entry to which a given iterator points.
+     *
+     * @param it A given iterator.
+     */
+    void eraseEntry(typename EntryList::iterator it);
 
     /**
      * Evicts the least recently used entry from the cache.
@@ -122,82 +417,303 @@ template <class TKey, class TValue> class LRUCache {
     void evictLRUEntry();
 
   private:
-    std::map<key_type, typename std::list<KeyValuePair>::iterator> m_cache;
-    std::list<KeyValuePair> m_entries;
+    std::map<key_type, typename EntryList::iterator> m_cache;
+    EntryList m_entries;
+    weigher_type m_weigher;
     size_t m_maxSize;
     size_t m_size;
+    size_t m_weight;
+    duration m_defaultTimeToLive;
+    uint64_t m_now; /// Last time read from the clock, as a tick
+    std::unique_ptr<TimerWheel<key_type>> m_timerWheel; /// Created on first entry with a TTL
+    [[no_unique_address]] stats_type m_stats;
 };
 
-template <class TKey, class TValue>
-LRUCache<TKey, TValue>::LRUCache(size_t maxSize) : m_maxSize(maxSize), m_size(0) {
+template <class TKey, class TValue, class TWeigher, class TStats, class TClock>
+LRUCache<TKey, TValue, TWeigher, TStats, TClock>::LRUCache(size_t maxSize, weigher_type weigher)
+    : m_weigher(std::move(weigher)), m_maxSize(maxSize), m_size(0), m_weight(0),
+      m_defaultTimeToLive(duration::zero()), m_now(toTick(clock_type::now())) {
     m_maxSize = std::max(static_cast<size_t>(1), m_maxSize);
 }
 
-template <class TKey, class TValue>
-TValue &LRUCache<TKey, TValue>::operator[](const key_type &key) {
+template <class TKey, class TValue, class TWeigher, class TStats, class TClock>
+LRUCache<TKey, TValue, TWeigher, TStats, TClock>::LRUCache(const LRUCache &other)
+    : m_entries(other.m_entries), m_weigher(other.m_weigher), m_maxSize(other.m_maxSize),
+      m_size(other.m_size), m_weight(other.m_weight),
+      m_defaultTimeToLive(other.m_defaultTimeToLive), m_now(other.m_now) {
+    rebuildIndex(other);
+}
+
+template <class TKey, class TValue, class TWeigher, class TStats, class TClock>
+LRUCache<TKey, TValue, TWeigher, TStats, TClock>::LRUCache(LRUCache &&other) noexcept
+    : m_cache(std::move(other.m_cache)), m_entries(std::move(other.m_entries)),
+      m_weigher(std::move(other.m_weigher)), m_maxSize(other.m_maxSize), m_size(other.m_size),
+      m_weight(other.m_weight), m_defaultTimeToLive(other.m_defaultTimeToLive),
+      m_now(other.m_now), m_timerWheel(std::move(other.m_timerWheel)) {
+    resetMovedFrom(other);
+}
+
+template <class TKey, class TValue, class TWeigher, class TStats, class TClock>
+LRUCache<TKey, TValue, TWeigher, TStats, TClock> &
+LRUCache<TKey, TValue, TWeigher, TStats, TClock>::operator=(const LRUCache &other) {
+    if (this == &other)
+        return *this;
+
+    m_entries = other.m_entries;
+    m_weigher = other.m_weigher;
+    m_maxSize = other.m_maxSize;
+    m_size = other.m_size;
+    m_weight = other.m_weight;
+    m_defaultTimeToLive = other.m_defaultTimeToLive;
+    m_now = std::max(m_now, other.m_now);
+    rebuildIndex(other);
+
+    return *this;
+}
+
+template <class TKey, class TValue, class TWeigher, class TStats, class TClock>
+LRUCache<TKey, TValue, TWeigher, TStats, TClock> &
+LRUCache<TKey, TValue, TWeigher, TStats, TClock>::operator=(LRUCache &&other) noexcept {
+    if (this == &other)
+        return *this;
+
+    // Lists moved by assignment keep their iterators valid, so the map stays correct
+    m_cache = std::move(other.m_cache);
+    m_entries = std::move(other.m_entries);
+    m_weigher = std::move(other.m_weigher);
+    m_maxSize = other.m_maxSize;
+    m_size = other.m_size;
+    m_weight = other.m_weight;
+    m_defaultTimeToLive = other.m_defaultTimeToLive;
+    m_now = std::max(m_now, other.m_now);
+    m_timerWheel = std::move(other.m_timerWheel);
+    resetMovedFrom(other);
+
+    return *this;
+}
+
+template <class TKey, class TValue, class TWeigher, class TStats, class TClock>
+TValue &LRUCache<TKey, TValue, TWeigher, TStats, TClock>::operator[](const key_type &key) {
+    [[maybe_unused]] const auto timer = m_stats.timeAccess();
     const auto it = m_cache.find(key);
 
-    if (it != m_cache.end()) {
+    if (it != m_cache.end() && !isExpired(it->second)) {
+        m_stats.recordHit();
         touchEntry(it->second);
     } else {
-        insert(key, value_type());
+        m_stats.recordMiss();
+
+        if (it != m_cache.end()) {
+            m_stats.recordExpiration();
+            eraseEntry(it->second);
+        }
+
+        m_stats.recordInsert();
+        const value_type value{};
+        admitEntry(key, value, m_weigher(key, value), m_defaultTimeToLive);
     }
 
-    return m_entries.front().second;
+    return m_entries.front().value;
 }
 
-template <class TKey, class TValue>
-void LRUCache<TKey, TValue>::insert(const key_type &key, const value_type &value) {
+template <class TKey, class TValue, class TWeigher, class TStats, class TClock>
+bool LRUCache<TKey, TValue, TWeigher, TStats, TClock>::insert(const key_type &key,
+                                                              const value_type &value) {
+    return insert(key, value, m_defaultTimeToLive);
+}
+
+template <class TKey, class TValue, class TWeigher, class TStats, class TClock>
+bool LRUCache<TKey, TValue, TWeigher, TStats, TClock>::insert(const key_type &key,
+                                                              const value_type &value,
+                                                              duration timeToLive) {
     const auto it = m_cache.find(key);
 
     if (it != m_cache.end()) {
-        m_entries.erase(it->second);
-    } else if (m_size == m_maxSize) {
-        evictLRUEntry();
-    } else {
-        ++m_size;
+        m_stats.recordReplacement();
+        eraseEntry(it->second);
     }
 
-    m_entries.push_front(std::make_pair(key, value));
-    m_cache[key] = m_entries.begin();
+    const size_t weight = m_weigher(key, value);
+
+    if (weight > m_maxSize)
+        return false;
+
+    m_stats.recordInsert();
+    admitEntry(key, value, weight, timeToLive);
+
+    return true;
+}
+
+template <class TKey, class TValue, class TWeigher, class TStats, class TClock>
+bool LRUCache<TKey, TValue, TWeigher, TStats, TClock>::contains(const key_type &key) {
+    return find(key) != nullptr;
 }
 
-template <class TKey, class TValue> bool LRUCache<TKey, TValue>::contains(const key_type &key) {
+template <class TKey, class TValue, class TWeigher, class TStats, class TClock>
+TValue *LRUCache<TKey, TValue, TWeigher, TStats, TClock>::find(const key_type &key) {
+    [[maybe_unused]] const auto timer = m_stats.timeAccess();
     const auto it = m_cache.find(key);
 
     if (it == m_cache.end()) {
-        return false;
+        m_stats.recordMiss();
+        return nullptr;
+    }
+
+    if (isExpired(it->second)) {
+        m_stats.recordMiss();
+        m_stats.recordExpiration();
+        eraseEntry(it->second);
+        return nullptr;
     }
 
+    m_stats.recordHit();
     touchEntry(it->second);
 
-    return true;
+    return &it->second->value;
 }
 
-template <class TKey, class TValue> bool LRUCache<TKey, TValue>::remove(const key_type &key) {
+template <class TKey, class TValue, class TWeigher, class TStats, class TClock>
+bool LRUCache<TKey, TValue, TWeigher, TStats, TClock>::remove(const key_type &key) {
     const auto it = m_cache.find(key);
 
     if (it == m_cache.end())
         return false;
 
-    --m_size;
-    m_entries.erase(it->second);
-    m_cache.erase(it);
+    m_stats.recordExplicitRemoval();
+    eraseEntry(it->second);
 
     return true;
 }
 
-template <class TKey, class TValue>
-void LRUCache<TKey, TValue>::touchEntry(typename std::list<KeyValuePair>::iterator &it) {
-    const auto &[key, value] = *it;
-    m_entries.push_front(std::make_pair(key, value));
+template <class TKey, class TValue, class TWeigher, class TStats, class TClock>
+void LRUCache<TKey, TValue, TWeigher, TStats, TClock>::expire(time_point now) {
+    m_now = std::max(m_now, toTick(now));
+
+    if (!m_timerWheel)
+        return;
+
+    m_timerWheel->advance(m_now, [this](const key_type &key) {
+        const auto it = m_cache.find(key)->second;
+        it->deadline = 0; // The timer is already gone
+        m_stats.recordExpiration();
+        eraseEntry(it);
+    });
+}
+
+template <class TKey, class TValue, class TWeigher, class TStats, class TClock>
+void LRUCache<TKey, TValue, TWeigher, TStats, TClock>::touchEntry(typename EntryList::iterator it) {
+    m_entries.splice(m_entries.begin(), m_entries, it);
+}
+
+template <class TKey, class TValue, class TWeigher, class TStats, class TClock>
+void LRUCache<TKey, TValue, TWeigher, TStats, TClock>::admitEntry(const key_type &key,
+                                                                  const value_type &value,
+                                                                  size_t weight,
+                                                                  duration timeToLive) {
+    while (!m_entries.empty() && m_weight + weight > m_maxSize)
+        evictLRUEntry();
+
+    m_entries.push_front(Entry{key, value, weight, 0, Timer()});
+    scheduleExpiration(m_entries.begin(), timeToLive);
+
+    m_cache.emplace(key, m_entries.begin());
+    m_weight += weight;
+    ++m_size;
+}
+
+template <class TKey, class TValue, class TWeigher, class TStats, class TClock>
+bool LRUCache<TKey, TValue, TWeigher, TStats, TClock>::append(const key_type &key,
+                                                              const value_type &value) {
+    const size_t weight = m_weigher(key, value);
+
+    if (m_weight + weight > m_maxSize || m_cache.count(key) != 0)
+        return false;
+
+    m_stats.recordInsert();
+    m_entries.push_back(Entry{key, value, weight, 0, Timer()});
+    scheduleExpiration(std::prev(m_entries.end()), m_defaultTimeToLive);
+
+    m_cache.emplace(key, std::prev(m_entries.end()));
+    m_weight += weight;
+    ++m_size;
+
+    return true;
+}
+
+template <class TKey, class TValue, class TWeigher, class TStats, class TClock>
+std::vector<std::pair<TKey, TValue>>
+LRUCache<TKey, TValue, TWeigher, TStats, TClock>::entries() const {
+    std::vector<std::pair<key_type, value_type>> result;
+    result.reserve(m_size);
+
+    for (const auto &entry : m_entries)
+        result.emplace_back(entry.key, entry.value);
+
+    return result;
+}
+
+template <class TKey, class TValue, class TWeigher, class TStats, class TClock>
+void LRUCache<TKey, TValue, TWeigher, TStats, TClock>::scheduleExpiration(
+    typename EntryList::iterator it, duration timeToLive) {
+    if (timeToLive <= duration::zero())
+        return;
+
+    const auto ttl = std::chrono::ceil<std::chrono::milliseconds>(timeToLive).count();
+
+    // The last time read may be far behind if the cache was idle, so deadlines are measured
+    // from the clock
+    refreshClock();
+    it->deadline = m_now + ttl;
+
+    if (!m_timerWheel)
+        m_timerWheel = std::make_unique<TimerWheel<key_type>>(m_now);
+
+    it->timer = m_timerWheel->schedule(it->key, it->deadline);
+}
+
+template <class TKey, class TValue, class TWeigher, class TStats, class TClock>
+void LRUCache<TKey, TValue, TWeigher, TStats, TClock>::resetMovedFrom(LRUCache &other) {
+    // Moved-from containers are only guaranteed to be valid, not empty
+    other.m_cache.clear();
+    other.m_entries.clear();
+    other.m_timerWheel.reset();
+    other.m_size = 0;
+    other.m_weight = 0;
+}
+
+template <class TKey, class TValue, class TWeigher, class TStats, class TClock>
+void LRUCache<TKey, TValue, TWeigher, TStats, TClock>::rebuildIndex(const LRUCache &other) {
+    m_cache.clear();
+    m_timerWheel.reset();
+
+    // The handles of the copied timers point into the wheel of the other cache, so the timers
+    // are scheduled again from the deadlines of the entries
+    if (other.m_timerWheel)
+        m_timerWheel = std::make_unique<TimerWheel<key_type>>(other.m_timerWheel->currentTick());
+
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        m_cache.emplace(it->key, it);
+        it->timer = Timer();
+
+        if (it->deadline != 0)
+            it->timer = m_timerWheel->schedule(it->key, it->deadline);
+    }
+}
+
+template <class TKey, class TValue, class TWeigher, class TStats, class TClock>
+void LRUCache<TKey, TValue, TWeigher, TStats, TClock>::eraseEntry(typename EntryList::iterator it) {
+    if (it->deadline != 0)
+        m_timerWheel->cancel(it->timer);
+
+    m_weight -= it->weight;
+    --m_size;
+    m_cache.erase(it->key);
     m_entries.erase(it);
-    m_cache[key] = m_entries.begin();
 }
 
-template <class TKey, class TValue> void LRUCache<TKey, TValue>::evictLRUEntry() {
-    const auto lru = m_entries.back();
-    m_cache.erase(lru.first);
-    m_entries.pop_back();
+template <class TKey, class TValue, class TWeigher, class TStats, class TClock>
+void LRUCache<TKey, TValue, TWeigher, TStats, TClock>::evictLRUEntry() {
+    m_stats.recordEviction();
+    eraseEntry(std::prev(m_entries.end()));
 }
 } // namespace cake
\ No newline at end of file
@@ -0,0 +1,412 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <cake/LRUCache.h>
+#include <cake/MemoryUsage.h>
+
+namespace cake {
+
+/**
+ * Loading Cache. Wraps an LRUCache and fills it on demand through a loader callable,
+ * typically a call to a slower backend. All operations are thread safe.
+ *
+ * Concurrent misses on the same key are coalesced: only one of the callers runs the loader,
+ * and the others wait on a future for its result. Entries may have a time to live and,
+ * before it runs out, be refreshed ahead of time in the background while the current
+ * value keeps being served.
+ *
+ * Ages of entries are measured with the clock, from the time they were loaded. A refresh that
+ * fails is not retried until the refresh age passes again.
+ * Statistics are collected according to the TStats policy, as in LRUCache.
+ */
+template <class TKey, class TValue, class TStats = NoCacheStats,
+          class TClock = std::chrono::steady_clock>
+class LoadingCache {
+  public:
+    using key_type = TKey;
+    using value_type = TValue;
+    using loader_type = std::function<value_type(const key_type &)>;
+    using clock_type = TClock;
+    using time_point = typename clock_type::time_point;
+    using duration = typename clock_type::duration;
+    using stats_type = TStats;
+
+  private:
+    struct LoadedValue {
+        value_type value;
+        time_point loadTime;
+    };
+
+  public:
+    /**
+     * Constructor. A maximum size of zero is converted to one.
+     *
+     * @param maxSize Maximum number of entries allowed.
+     * @param loader Callable that produces the value of a key that is not in the cache.
+     * It may be invoked concurrently for different keys, and may throw.
+     */
+    LoadingCache(size_t maxSize, loader_type loader);
+
+    /**
+     * Destructor. Waits for background refreshes to finish.
+     */
+    ~LoadingCache();
+
+    LoadingCache(const LoadingCache &) = delete;
+    LoadingCache &operator=(const LoadingCache &) = delete;
+
+    /**
+     * Returns the number of entries currently in the cache.
+     */
+    size_t size() const;
+
+    /**
+     * Returns an estimate of the memory used by the cache: the cache object, the wrapped
+     * LRUCache, and the bookkeeping of the loads and refreshes in progress. Memory owned by
+     * the keys and values themselves is not counted.
+     *
+     * @return The number of bytes.
+     */
+    size_t memoryUsage() const;
+
+    /**
+     * Returns the value associated to a given key, loading it if it is not in the cache. If
+     * the key is already being loaded by another caller, waits for that load instead of
+     * starting a new one. If the entry is due for a refresh, a background refresh is started
+     * and the current value is returned.
+     *
+     * @param key The given key.
+     *
+     * @return The associated value.
+     *
+     * @throws Whatever the loader threw, if loading the value failed.
+     */
+    value_type get(const key_type &key);
+
+    /**
+     * Removes the entry with the given key. A load of the key that is already in flight is
+     * not cancelled.
+     *
+     * @param key The given key.
+     *
+     * @return true if an entry was removed from the cache, false otherwise.
+     */
+    bool invalidate(const key_type &key);
+
+    /**
+     * Sets the time after which loaded entries expire. Zero means that they never expire.
+     * Entries already in the cache are not affected.
+     *
+     * @param timeToLive The given time to live.
+     */
+    void setTimeToLive(duration timeToLive);
+
+    /**
+     * Sets the age after which an entry is refreshed in the background on its next access.
+     * To be useful, it must be shorter than the time to live. Zero disables refreshing.
+     *
+     * @param refreshAfter The given age.
+     */
+    void setRefreshAfter(duration refreshAfter);
+
+    /**
+     * Advances the current time of the cache and removes all the entries that expired.
+     *
+     * @param now The new current time.
+     */
+    void expire(time_point now = clock_type::now());
+
+    /**
+     * Returns a snapshot of the statistics of the underlying LRUCache, which uses the
+     * statistics policy of this cache. With NoCacheStats, all values are zero.
+     */
+    CacheStats stats() const { return m_cache.stats(); }
+
+    /**
+     * Writes the entries of the cache to a snapshot (see CacheSnapshot). The cache is only
+     * locked while its entries are copied, not while they are written.
+     *
+     * @param output Stream the snapshot is written to.
+     *
+     * @return true if the snapshot was written successfully.
+     */
+    template <typename TKeySerializer = Serializer<key_type>,
+              typename TValueSerializer = Serializer<value_type>>
+    bool saveSnapshot(std::ostream &output) const;
+
+    /**
+     * Fills the cache from a snapshot (see LRUCache::loadSnapshot). Loaded entries count as
+     * loaded now, for the purpose of refreshing them.
+     *
+     * @param input Stream the snapshot is read from.
+     *
+     * @return true if the snapshot was valid, false otherwise.
+     */
+    template <typename TKeySerializer = Serializer<key_type>,
+              typename TValueSerializer = Serializer<value_type>>
+    bool loadSnapshot(std::istream &input);
+
+  private:
+    /**
+     * Runs the loader for a given key and publishes the outcome to the cache and to the
+     * callers waiting on it. The key must be registered as in flight.
+     *
+     * @param key The given key.
+     * @param promise Promise the waiters of the load are waiting on.
+     * @param isRefresh Whether the load refreshes a cached value, so that a failure delays
+     * the next refresh.
+     *
+     * @return The loaded value.
+     */
+    value_type load(const key_type &key, std::promise<value_type> &promise,
+                    bool isRefresh = false);
+
+    /**
+     * Starts a background load of a given key, unless a load is already in flight or a
+     * refresh of the key failed less than the refresh age ago. The mutex must be held by the
+     * caller.
+     *
+     * @param key The given key.
+     * @param now The current time.
+     */
+    void startRefresh(const key_type &key, time_point now);
+
+    /**
+     * Forgets the refreshes that finished, and the failed refreshes that may be retried.
+     * The mutex must be held by the caller.
+     *
+     * @param now The current time.
+     */
+    void pruneRefreshes(time_point now);
+
+  private:
+    mutable std::mutex m_mutex;
+    LRUCache<key_type, LoadedValue, UnitWeigher, stats_type, clock_type> m_cache;
+    loader_type m_loader;
+    std::map<key_type, std::shared_future<value_type>> m_inFlight;
+    std::list<std::future<void>> m_refreshes;
+    std::map<key_type, time_point> m_failedRefreshes; /// Time of the last failure, by key
+    duration m_refreshAfter;
+};
+
+template <class TKey, class TValue, class TStats, class TClock>
+LoadingCache<TKey, TValue, TStats, TClock>::LoadingCache(size_t maxSize, loader_type loader)
+    : m_cache(maxSize), m_loader(std::move(loader)), m_refreshAfter(duration::zero()) {}
+
+template <class TKey, class TValue, class TStats, class TClock>
+LoadingCache<TKey, TValue, TStats, TClock>::~LoadingCache() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto refreshes = std::move(m_refreshes);
+    lock.unlock();
+
+    for (auto &refresh : refreshes)
+        refresh.wait();
+}
+
+template <class TKey, class TValue, class TStats, class TClock>
+size_t LoadingCache<TKey, TValue, TStats, TClock>::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_cache.size();
+}
+
+template <class TKey, class TValue, class TStats, class TClock>
+size_t LoadingCache<TKey, TValue, TStats, TClock>::memoryUsage() const {
+    using InFlightValue = typename decltype(m_inFlight)::value_type;
+    using FailedRefreshValue = typename decltype(m_failedRefreshes)::value_type;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return sizeof(*this) - sizeof(m_cache) + m_cache.memoryUsage() +
+           m_inFlight.size() * MemoryUsage::treeNode<InFlightValue> +
+           m_refreshes.size() * MemoryUsage::listNode<std::future<void>> +
+           m_failedRefreshes.size() * MemoryUsage::treeNode<FailedRefreshValue>;
+}
+
+template <class TKey, class TValue, class TStats, class TClock>
+TValue LoadingCache<TKey, TValue, TStats, TClock>::get(const key_type &key) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (const auto *loaded = m_cache.find(key)) {
+        if (m_refreshAfter > duration::zero()) {
+            const time_point now = clock_type::now();
+
+            if (now - loaded->loadTime >= m_refreshAfter)
+                startRefresh(key, now);
+        }
+
+        return loaded->value;
+    }
+
+    const auto it = m_inFlight.find(key);
+
+    if (it != m_inFlight.end()) {
+        const auto result = it->second;
+        lock.unlock();
+        return result.get();
+    }
+
+    std::promise<value_type> promise;
+    m_inFlight.emplace(key, promise.get_future().share());
+    lock.unlock();
+
+    return load(key, promise);
+}
+
+template <class TKey, class TValue, class TStats, class TClock>
+bool LoadingCache<TKey, TValue, TStats, TClock>::invalidate(const key_type &key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_cache.remove(key);
+}
+
+template <class TKey, class TValue, class TStats, class TClock>
+void LoadingCache<TKey, TValue, TStats, TClock>::setTimeToLive(duration timeToLive) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cache.setDefaultTimeToLive(timeToLive);
+}
+
+template <class TKey, class TValue, class TStats, class TClock>
+void LoadingCache<TKey, TValue, TStats, TClock>::setRefreshAfter(duration refreshAfter) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_refreshAfter = refreshAfter;
+}
+
+template <class TKey, class TValue, class TStats, class TClock>
+void LoadingCache<TKey, TValue, TStats, TClock>::expire(time_point now) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cache.expire(now);
+    pruneRefreshes(now);
+}
+
+template <class TKey, class TValue, class TStats, class TClock>
+template <typename TKeySerializer, typename TValueSerializer>
+bool LoadingCache<TKey, TValue, TStats, TClock>::saveSnapshot(std::ostream &output) const {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const auto loadedEntries = m_cache.entries();
+    lock.unlock();
+
+    std::vector<std::pair<key_type, value_type>> entries;
+    entries.reserve(loadedEntries.size());
+
+    for (const auto &[key, loaded] : loadedEntries)
+        entries.emplace_back(key, loaded.value);
+
+    return CacheSnapshot::write<key_type, value_type, TKeySerializer, TValueSerializer>(output,
+                                                                                       entries);
+}
+
+template <class TKey, class TValue, class TStats, class TClock>
+template <typename TKeySerializer, typename TValueSerializer>
+bool LoadingCache<TKey, TValue, TStats, TClock>::loadSnapshot(std::istream &input) {
+    const time_point loadTime = clock_type::now();
+
+    return CacheSnapshot::read<key_type, value_type, TKeySerializer, TValueSerializer>(
+        input, [this, loadTime](const key_type &key, const value_type &value) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_cache.append(key, LoadedValue{value, loadTime});
+            return m_cache.currentWeight() < m_cache.maxSize();
+        });
+}
+
+template <class TKey, class TValue, class TStats, class TClock>
+TValue LoadingCache<TKey, TValue, TStats, TClock>::load(const key_type &key,
+                                                       std::promise<value_type> &promise,
+                                                       bool isRefresh) {
+    try {
+        value_type value = m_loader(key);
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cache.insert(key, LoadedValue{value, clock_type::now()});
+        m_inFlight.erase(key);
+        m_failedRefreshes.erase(key);
+        lock.unlock();
+
+        promise.set_value(value);
+
+        return value;
+    } catch (...) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_inFlight.erase(key);
+
+        // Refreshes back off, rather than starting a thread on every access while they fail
+        if (isRefresh)
+            m_failedRefreshes[key] = clock_type::now();
+
+        lock.unlock();
+
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+}
+
+template <class TKey, class TValue, class TStats, class TClock>
+void LoadingCache<TKey, TValue, TStats, TClock>::startRefresh(const key_type &key,
+                                                              time_point now) {
+    if (m_inFlight.count(key) != 0)
+        return;
+
+    pruneRefreshes(now);
+
+    if (m_failedRefreshes.count(key) != 0)
+        return;
+
+    auto promise = std::make_shared<std::promise<value_type>>();
+    m_inFlight.emplace(key, promise->get_future().share());
+
+    m_refreshes.push_back(std::async(std::launch::async, [this, key, promise]() {
+        try {
+            load(key, *promise, true);
+        } catch (...) {
+            // A failed refresh keeps serving the current value until it expires
+        }
+    }));
+}
+
+template <class TKey, class TValue, class TStats, class TClock>
+void LoadingCache<TKey, TValue, TStats, TClock>::pruneRefreshes(time_point now) {
+    m_refreshes.remove_if([](const std::future<void> &refresh) {
+        return refresh.wait_for(duration::zero()) == std::future_status::ready;
+    });
+
+    for (auto it = m_failedRefreshes.begin(); it != m_failedRefreshes.end();) {
+        if (now - it->second >= m_refreshAfter)
+            it = m_failedRefreshes.erase(it);
+        else
+            ++it;
+    }
+}
+} // namespace cake
@@ -0,0 +1,80 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace cake {
+
+/**
+ * Read-only memory mapping of a whole file. The mapping is shared with every other process
+ * that maps the same file, and is released when the object is destroyed.
+ */
+class MappedFile {
+  public:
+    /**
+     * Constructor. Creates an object that maps no file.
+     */
+    MappedFile();
+
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    ~MappedFile();
+
+    /**
+     * Maps a file, releasing the file mapped before, if any.
+     *
+     * @param path Path of the file.
+     *
+     * @return true if the file was mapped, otherwise false.
+     */
+    bool open(const std::string &path);
+
+    /**
+     * Releases the mapped file, if any.
+     */
+    void close();
+
+    /** Returns the start of the mapped file, which is aligned to a page.
+     *
+     * @return Pointer to the contents of the file, or nullptr if no file is mapped.
+     */
+    const void *data() const { return m_data; }
+
+    /** Returns the size of the mapped file.
+     *
+     * @return The number of bytes mapped.
+     */
+    size_t size() const { return m_size; }
+
+  private:
+    void *m_data;
+    size_t m_size;
+};
+
+} // namespace cake
@@ -0,0 +1,51 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace cake {
+namespace MemoryUsage {
+
+/**
+ * Estimates of the memory taken by a node of the node-based standard containers, for the
+ * memoryUsage() of the containers built on them. They count the value and the links of the
+ * node, but neither the overhead of the heap nor memory owned by the value itself.
+ */
+
+/// Node of std::list: the value and two links
+template <typename TValue> constexpr size_t listNode = sizeof(TValue) + 2 * sizeof(void *);
+
+/// Node of std::map and std::set: the value, three links and the color
+template <typename TValue> constexpr size_t treeNode = sizeof(TValue) + 4 * sizeof(void *);
+
+/// Node of std::unordered_map and std::unordered_set: the value, a link and the cached hash
+template <typename TValue> constexpr size_t hashNode = sizeof(TValue) + 2 * sizeof(void *);
+
+/// Bucket of std::unordered_map and std::unordered_set
+constexpr size_t hashBucket = sizeof(void *);
+
+} // namespace MemoryUsage
+} // namespace cake
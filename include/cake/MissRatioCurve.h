@@ -0,0 +1,164 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <cake/AccessTrace.h>
+
+namespace cake {
+
+/**
+ * Miss Ratio Curve of an LRU cache. Given a key access trace, computes in a single pass the
+ * miss ratio that an LRU cache would have for every possible size, which is what is needed to
+ * right-size a cache.
+ *
+ * Every access is classified by its stack distance: the number of distinct keys accessed since
+ * the previous access to the same key. An access hits in an LRU cache of size c if and only if
+ * its stack distance is smaller than c. Stack distances are computed with a Fenwick tree over
+ * access times, in O(log n) per access.
+ *
+ * For very large traces, SHARDS spatial sampling can be used: only keys whose hash falls under
+ * a threshold are tracked, and their stack distances are scaled by the inverse of the sampling
+ * rate. Memory and time shrink proportionally to the sampling rate.
+ */
+class MissRatioCurve {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param samplingRate Fraction of the keys that is tracked. Values are clamped to the
+     * interval [0.0001, 1]; a value of 1 computes the exact curve.
+     */
+    explicit MissRatioCurve(double samplingRate = 1.0);
+
+    /**
+     * Returns the sampling rate, as specified in constructor parameter.
+     */
+    double samplingRate() const { return m_samplingRate; }
+
+    /**
+     * Returns the number of accesses processed, sampled or not.
+     */
+    uint64_t numAccesses() const { return m_numAccesses; }
+
+    /**
+     * Processes an access to a given key.
+     *
+     * @param key The given key.
+     */
+    void access(uint64_t key);
+
+    /**
+     * Processes all the remaining accesses of a trace.
+     *
+     * @param trace The given trace.
+     */
+    void access(AccessTraceReader &trace);
+
+    /**
+     * Returns the miss ratio of an LRU cache of a given size over the accesses processed so
+     * far. Misses include cold misses, i.e. the first access to every key.
+     *
+     * @param cacheSize The given cache size, as a number of entries.
+     *
+     * @return A value in the range [0.0, 1.0], or zero if no access was processed.
+     */
+    double missRatio(size_t cacheSize) const;
+
+    /**
+     * Returns the miss ratios of LRU caches of given sizes.
+     *
+     * @param cacheSizes The given cache sizes.
+     *
+     * @return The miss ratio for every given size, in the same order.
+     */
+    std::vector<double> missRatios(const std::vector<size_t> &cacheSizes) const;
+
+    /**
+     * Returns the full curve as the points at which the miss ratio changes.
+     *
+     * @return Pairs of cache size and miss ratio, in increasing order of cache size. The miss
+     * ratio of sizes between two points is the one of the smaller point.
+     */
+    std::vector<std::pair<size_t, double>> curve() const;
+
+  private:
+    /**
+     * Adds a given delta to the mark count of a given access time in the Fenwick tree.
+     */
+    void updateMark(uint64_t time, int64_t delta);
+
+    /**
+     * Returns the number of marks with an access time up to and including a given one.
+     */
+    uint64_t countMarks(uint64_t time) const;
+
+    /**
+     * Renumbers the access times of the tracked keys to 0..n-1 and rebuilds the Fenwick tree,
+     * so that it only grows with the number of distinct keys, not with the trace length.
+     */
+    void compact();
+
+  private:
+    double m_samplingRate;
+    uint64_t m_samplingThreshold;
+    uint64_t m_numAccesses;
+    uint64_t m_numSampled;
+    uint64_t m_numColdMisses;
+    std::vector<uint64_t> m_distanceCounts; /// Histogram of sampled stack distances
+    std::unordered_map<uint64_t, uint64_t> m_lastAccess; /// Key to time of its last access
+    std::vector<uint32_t> m_fenwick; /// Marks the time of the last access of every key
+    uint64_t m_time;
+};
+
+/**
+ * Miss ratios of the eviction policies of cake for a given cache size.
+ */
+struct PolicyComparison {
+    size_t cacheSize;
+    double lruMissRatio;     /// Measured by replaying the trace through an LRUCache
+    double tinyLFUMissRatio; /// Measured by replaying the trace through a TinyLFUCache
+    double curveMissRatio;   /// Predicted by the MissRatioCurve
+};
+
+/**
+ * Replays a trace through LRUCache and TinyLFUCache instances of given sizes, and through a
+ * MissRatioCurve, all in a single pass over the trace.
+ *
+ * @param trace The given trace.
+ * @param cacheSizes The given cache sizes.
+ * @param samplingRate Sampling rate of the MissRatioCurve.
+ *
+ * @return The comparison for every given size, in the same order.
+ */
+std::vector<PolicyComparison> comparePolicies(AccessTraceReader &trace,
+                                              const std::vector<size_t> &cacheSizes,
+                                              double samplingRate = 1.0);
+} // namespace cake
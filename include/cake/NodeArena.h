@@ -0,0 +1,151 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <new>
+#include <vector>
+
+namespace cake {
+
+/**
+ * Node allocators. A node allocator hands out raw memory for the nodes of a data structure,
+ * which are created with placement new and must be trivially destructible. It provides:
+ *
+ *  - void *allocate(size_t size)
+ *  - void deallocate(void *pointer, size_t size), with the size given to allocate.
+ *  - void merge(Allocator &other), which takes over the memory of another allocator of the
+ *    same type, so that nodes can be built with separate allocators in different threads.
+ *  - size_t bytesReserved() const, the memory the allocator holds, whether used by nodes or not.
+ *  - static constexpr bool ownsAllMemory; if true, destroying the allocator frees every node
+ *    it allocated, and a data structure can be torn down without visiting its nodes.
+ */
+
+/**
+ * Node allocator that allocates every node from the heap.
+ */
+class HeapNodeAllocator {
+  public:
+    static constexpr bool ownsAllMemory = false;
+
+    void *allocate(size_t size) {
+        m_bytesReserved += size;
+        return ::operator new(size);
+    }
+
+    void deallocate(void *pointer, size_t size) {
+        m_bytesReserved -= size;
+        ::operator delete(pointer, size);
+    }
+
+    void merge(HeapNodeAllocator &other) {
+        m_bytesReserved += other.m_bytesReserved;
+        other.m_bytesReserved = 0;
+    }
+
+    /// Bytes of the nodes allocated and not yet deallocated, without the overhead of the heap
+    size_t bytesReserved() const { return m_bytesReserved; }
+
+  private:
+    size_t m_bytesReserved = 0;
+};
+
+/**
+ * Node allocator that carves nodes out of large chunks of memory. Allocation bumps a pointer
+ * within the current chunk, freed nodes are kept in a free list per size for reuse, and all
+ * the chunks are freed at once when the arena is destroyed. Nodes allocated together end up
+ * next to each other, which helps the locality of traversals. Not thread-safe.
+ */
+class NodeArena {
+  public:
+    static constexpr bool ownsAllMemory = true;
+
+    /**
+     * Constructor. Creates an arena without any memory.
+     */
+    NodeArena();
+
+    NodeArena(NodeArena &&other) noexcept;
+    NodeArena &operator=(NodeArena &&other) noexcept;
+    NodeArena(const NodeArena &) = delete;
+    NodeArena &operator=(const NodeArena &) = delete;
+    ~NodeArena();
+
+    /**
+     * Allocates memory for a node.
+     *
+     * @param size Size of the node in bytes.
+     *
+     * @return Memory aligned to 16 bytes.
+     */
+    void *allocate(size_t size);
+
+    /**
+     * Frees the memory of a node for reuse by nodes of the same size.
+     *
+     * @param pointer Memory returned by allocate.
+     * @param size Size given to allocate.
+     */
+    void deallocate(void *pointer, size_t size);
+
+    /**
+     * Takes over all the memory of another arena, which is left empty.
+     *
+     * @param other Given arena.
+     */
+    void merge(NodeArena &other);
+
+    /** Returns how much memory the arena holds, whether used by nodes or not.
+     *
+     * @return The number of bytes of all the chunks.
+     */
+    size_t bytesReserved() const { return m_bytesReserved; }
+
+  private:
+    static constexpr size_t alignment = 16;
+    static constexpr size_t chunkSize = 64 * 1024;
+    /// Sizes up to this have their free lists in a vector, larger ones in a map
+    static constexpr size_t maxSmallSize = 4096;
+
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    static size_t roundUp(size_t size) { return (size + alignment - 1) / alignment * alignment; }
+
+    FreeBlock *&freeList(size_t roundedSize);
+
+    void releaseChunks();
+
+    std::vector<void *> m_chunks;
+    char *m_next; /// Next free byte of the current chunk
+    char *m_end;  /// End of the current chunk
+    std::vector<FreeBlock *> m_smallFreeLists;
+    std::map<size_t, FreeBlock *> m_largeFreeLists;
+    size_t m_bytesReserved;
+};
+
+} // namespace cake
@@ -0,0 +1,226 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <cake/RollbackDisjointSet.h>
+
+namespace cake {
+
+/**
+ * Offline dynamic connectivity. Records a sequence of edge insertions, edge removals and
+ * connectivity queries on a graph of the vertices 0, 1, ..., numVertices - 1, and then
+ * answers all the queries at once.
+ *
+ * Every edge is present during an interval of queries. The intervals are stored in a
+ * segment tree over the queries, and a walk of the tree joins the edges of every tree node
+ * on the way down and rolls them back on the way up, with a RollbackDisjointSet. Each query
+ * is answered at its leaf, and the whole sequence takes O((m log q + q) log n) time for m
+ * edges and q queries.
+ */
+template <typename TElement> class OfflineConnectivity {
+  public:
+    using element_type = TElement;
+
+    /**
+     * Constructor. Creates a graph without edges.
+     *
+     * @param numVertices Number of vertices.
+     */
+    explicit OfflineConnectivity(size_t numVertices) : m_numVertices(numVertices) {}
+
+    /**
+     * Records the insertion of an edge. Edges may be inserted more than once, and are present
+     * until removed as many times.
+     *
+     * @param vertex1 The first vertex.
+     * @param vertex2 The second vertex.
+     */
+    void addEdge(element_type vertex1, element_type vertex2);
+
+    /**
+     * Records the removal of an edge.
+     *
+     * @param vertex1 The first vertex.
+     * @param vertex2 The second vertex.
+     * @return true, if the edge was present; false, otherwise.
+     */
+    bool removeEdge(element_type vertex1, element_type vertex2);
+
+    /**
+     * Records a query of whether two vertices are connected, by the edges present at this
+     * point of the sequence.
+     *
+     * @param vertex1 The first vertex.
+     * @param vertex2 The second vertex.
+     * @return The index of the query among the answers of solve().
+     */
+    size_t query(element_type vertex1, element_type vertex2);
+
+    /**
+     * Returns the number of queries recorded.
+     */
+    size_t numQueries() const { return m_queries.size(); }
+
+    /**
+     * Answers all the queries recorded.
+     *
+     * @return The answer of every query, by index.
+     */
+    std::vector<bool> solve() const;
+
+  private:
+    using Edge = std::pair<element_type, element_type>;
+
+    /// An edge present from the query firstQuery up to, but excluding, lastQuery
+    struct Interval {
+        Edge edge;
+        size_t firstQuery;
+        size_t lastQuery;
+    };
+
+    static Edge makeEdge(element_type vertex1, element_type vertex2) {
+        return {std::min(vertex1, vertex2), std::max(vertex1, vertex2)};
+    }
+
+    /**
+     * Adds an edge to the segment tree nodes that cover an interval of queries.
+     */
+    static void insert(std::vector<std::vector<Edge>> &tree, size_t node, size_t first,
+                       size_t last, const Interval &interval);
+
+    /**
+     * Answers the queries of a segment tree node, with the edges of its ancestors joined.
+     */
+    void solve(const std::vector<std::vector<Edge>> &tree, size_t node, size_t first,
+               size_t last, RollbackDisjointSet<element_type> &sets,
+               std::vector<bool> &answers) const;
+
+    size_t m_numVertices;
+    std::map<Edge, std::vector<size_t>> m_openEdges; /// First query of every present copy
+    std::vector<Interval> m_intervals;               /// Of the removed edges
+    std::vector<Edge> m_queries;
+};
+
+template <typename TElement>
+void OfflineConnectivity<TElement>::addEdge(element_type vertex1, element_type vertex2) {
+    m_openEdges[makeEdge(vertex1, vertex2)].push_back(m_queries.size());
+}
+
+template <typename TElement>
+bool OfflineConnectivity<TElement>::removeEdge(element_type vertex1, element_type vertex2) {
+    const auto it = m_openEdges.find(makeEdge(vertex1, vertex2));
+
+    if (it == m_openEdges.end())
+        return false;
+
+    m_intervals.push_back({it->first, it->second.back(), m_queries.size()});
+    it->second.pop_back();
+
+    if (it->second.empty())
+        m_openEdges.erase(it);
+
+    return true;
+}
+
+template <typename TElement>
+size_t OfflineConnectivity<TElement>::query(element_type vertex1, element_type vertex2) {
+    m_queries.emplace_back(vertex1, vertex2);
+
+    return m_queries.size() - 1;
+}
+
+template <typename TElement> std::vector<bool> OfflineConnectivity<TElement>::solve() const {
+    const size_t numQueries = m_queries.size();
+    std::vector<bool> answers(numQueries, false);
+
+    if (numQueries == 0)
+        return answers;
+
+    std::vector<std::vector<Edge>> tree(4 * numQueries);
+
+    for (const auto &interval : m_intervals)
+        insert(tree, 1, 0, numQueries, interval);
+
+    for (const auto &[edge, firstQueries] : m_openEdges) {
+        for (const size_t firstQuery : firstQueries)
+            insert(tree, 1, 0, numQueries, {edge, firstQuery, numQueries});
+    }
+
+    RollbackDisjointSet<element_type> sets(m_numVertices);
+
+    solve(tree, 1, 0, numQueries, sets, answers);
+
+    return answers;
+}
+
+template <typename TElement>
+void OfflineConnectivity<TElement>::insert(std::vector<std::vector<Edge>> &tree, size_t node,
+                                           size_t first, size_t last,
+                                           const Interval &interval) {
+    if (interval.lastQuery <= first || last <= interval.firstQuery)
+        return;
+
+    if (interval.firstQuery <= first && last <= interval.lastQuery) {
+        tree[node].push_back(interval.edge);
+        return;
+    }
+
+    const size_t middle = first + (last - first) / 2;
+
+    insert(tree, 2 * node, first, middle, interval);
+    insert(tree, 2 * node + 1, middle, last, interval);
+}
+
+template <typename TElement>
+void OfflineConnectivity<TElement>::solve(const std::vector<std::vector<Edge>> &tree,
+                                          size_t node, size_t first, size_t last,
+                                          RollbackDisjointSet<element_type> &sets,
+                                          std::vector<bool> &answers) const {
+    const auto checkpoint = sets.checkpoint();
+
+    for (const auto &[vertex1, vertex2] : tree[node])
+        sets.join(vertex1, vertex2);
+
+    if (last - first == 1) {
+        const auto &[vertex1, vertex2] = m_queries[first];
+
+        answers[first] = sets.sameSet(vertex1, vertex2);
+    } else {
+        const size_t middle = first + (last - first) / 2;
+
+        solve(tree, 2 * node, first, middle, sets, answers);
+        solve(tree, 2 * node + 1, middle, last, sets, answers);
+    }
+
+    sets.rollback(checkpoint);
+}
+
+} // namespace cake
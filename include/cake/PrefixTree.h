@@ -24,21 +24,67 @@
 
 #pragma once
 
-#include <map>
-#include <memory>
-#include <stack>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <cake/NodeArena.h>
+
 namespace cake {
 
+/**
+ * Score fields of the nodes of a PrefixTree with scores of type TScore.
+ */
+template <typename TScore> struct PrefixTreeScores {
+    /// Highest score of a subtree without words
+    static constexpr TScore noScore = std::numeric_limits<TScore>::has_infinity
+                                          ? -std::numeric_limits<TScore>::infinity()
+                                          : std::numeric_limits<TScore>::lowest();
+
+    TScore score = TScore();   /// Score of the word ending here, if any
+    TScore maxScore = noScore; /// Highest score of the words in the subtree
+};
+
+/// Nodes of a PrefixTree without scores have no score fields
+template <> struct PrefixTreeScores<void> {};
+
 /**
  * Prefix Tree data structure. Allows for quick retrieval of
  * all words that match a given prefix among a given set of words.
+ *
+ * Nodes use an adaptive layout, as in the Adaptive Radix Tree: a node starts with room for 4
+ * children and is reallocated into a larger kind as it grows (and back into a smaller one as
+ * it shrinks). For byte symbols the kinds are Node4, Node16 (searched with SIMD where
+ * available), Node48 (a 256-entry index into 48 children) and Node256 (direct indexing).
+ * Wider symbols use Node4, Node16, and a sorted array for larger fan-outs. Children are kept
+ * in increasing order of their symbols, compared as unsigned code units.
+ *
+ * With a score type TScore (e.g. double), words carry a score and every node keeps the
+ * highest score in its subtree, so that the best scored completions of a prefix can be found
+ * without visiting the whole subtree. Without one (the default), nodes have no score fields.
+ *
+ * Nodes are allocated by a node allocator (see NodeArena.h). The default NodeArena keeps the
+ * nodes together in large chunks, and frees the whole tree at once.
  */
-template <typename TString> class PrefixTree {
+template <typename TString, typename TAllocator = NodeArena, typename TScore = void>
+class PrefixTree {
   public:
     using string_type = TString;
     using symbol_type = typename TString::value_type;
+    using score_type = TScore;
 
     /**
      * Constructor. Creates an empty prefix tree.
@@ -50,7 +96,62 @@ template <typename TString> class PrefixTree {
      *
      * @param words Container of words.
      */
-    PrefixTree(const std::vector<string_type> &words);
+    PrefixTree(const std::vector<string_type> &words) : PrefixTree(words, 1) {}
+
+    /**
+     * Constructor. Creates a prefix tree with all the words in a given vector, in bulk. The
+     * words are sorted (unless they already are), and every word reuses the path of the
+     * previous one up to their common prefix, so the tree is built in a single pass. The
+     * subtrees of different first symbols are independent, and are built in parallel.
+     *
+     * @param words Container of words.
+     * @param numThreads Maximum number of threads to build with.
+     */
+    PrefixTree(const std::vector<string_type> &words, size_t numThreads);
+
+    /**
+     * Move constructor. The other tree is left empty and usable, with a root of its own, so
+     * the constructor allocates and is not noexcept.
+     */
+    PrefixTree(PrefixTree &&other);
+
+    /**
+     * Move assignment. The trees are swapped.
+     */
+    PrefixTree &operator=(PrefixTree &&other) noexcept;
+
+    PrefixTree(const PrefixTree &) = delete;
+    PrefixTree &operator=(const PrefixTree &) = delete;
+    ~PrefixTree();
+
+    /**
+     * Compares two words in the order of the prefix tree, which is lexicographic by unsigned
+     * code unit.
+     *
+     * @return true if the first word goes before the second, otherwise false.
+     */
+    static bool less(const string_type &a, const string_type &b) {
+        return std::lexicographical_compare(
+            a.begin(), a.end(), b.begin(), b.end(), [](symbol_type x, symbol_type y) {
+                return static_cast<key_type>(x) < static_cast<key_type>(y);
+            });
+    }
+
+    /// Number of nodes of a kind, and the bytes they take
+    struct NodeUsage {
+        size_t numNodes = 0;
+        size_t bytes = 0;
+    };
+
+    /// Usage of the nodes of every kind. Node48 and Node256 only hold byte symbols, and NodeN
+    /// only holds wider symbols.
+    struct MemoryBreakdown {
+        NodeUsage node4;
+        NodeUsage node16;
+        NodeUsage node48;
+        NodeUsage node256;
+        NodeUsage nodeN;
+    };
 
     /** Returns how many words the prefix tree contains.
      *
@@ -58,6 +159,26 @@ template <typename TString> class PrefixTree {
      */
     size_t size() const { return m_size; }
 
+    /**
+     * Returns the memory used by the prefix tree. It is kept up to date as nodes are created
+     * and destroyed, so this takes constant time.
+     *
+     * @return The number of bytes of the tree object and of all the memory held by its node
+     * allocator, including memory freed for reuse.
+     */
+    size_t memoryUsage() const { return sizeof(*this) + m_nodes.allocator.bytesReserved(); }
+
+    /**
+     * Returns how many nodes of every kind the prefix tree has, and the bytes they take.
+     *
+     * @return The usage of every node kind.
+     */
+    MemoryBreakdown memoryBreakdown() const {
+        const NodeUsage *usage = m_nodes.usage;
+
+        return {usage[0], usage[1], usage[2], usage[3], usage[4]};
+    }
+
     /**
      * Add a new word to the prefix tree, if the word was not already present.
      *
@@ -67,6 +188,29 @@ template <typename TString> class PrefixTree {
      */
     bool add(const string_type &word);
 
+    /**
+     * Add a new word with a given score to the prefix tree, if the word was not already
+     * present. Only available for trees with scores.
+     *
+     * @param word Given word.
+     * @param score Score of the word.
+     *
+     * @return true if the new word is not empty and was not already present, otherwise false.
+     */
+    template <typename T = TScore>
+    bool add(const string_type &word, std::enable_if_t<!std::is_void_v<T>, T> score);
+
+    /**
+     * Change the score of a word in the prefix tree. Only available for trees with scores.
+     *
+     * @param word Given word.
+     * @param score New score of the word.
+     *
+     * @return true if the word is present, otherwise false.
+     */
+    template <typename T = TScore>
+    bool setScore(const string_type &word, std::enable_if_t<!std::is_void_v<T>, T> score);
+
     /**
      * Remove a word from the prefix tree.
      *
@@ -85,132 +229,1152 @@ template <typename TString> class PrefixTree {
      */
     std::vector<string_type> query(const string_type &prefix) const;
 
+    /**
+     * Query prefix tree for the first words, in lexicographic order, that match a given
+     * prefix. Stops walking the tree as soon as enough words are found.
+     *
+     * @param prefix A given prefix.
+     * @param limit Maximum number of words to return.
+     *
+     * @return A vector with at most limit words that match the given prefix.
+     */
+    std::vector<string_type> query(const string_type &prefix, size_t limit) const;
+
+    /**
+     * Visit the words that match a given prefix in lexicographic order, without
+     * materializing them. The word is passed in a buffer that is reused between calls, so
+     * it is only valid during the call.
+     *
+     * @param prefix A given prefix. An empty prefix matches every word.
+     * @param visitor Callable taking a const string_type &; returns false to stop the walk.
+     *
+     * @return false if the visitor stopped the walk, otherwise true.
+     */
+    template <typename TVisitor> bool forEach(const string_type &prefix, TVisitor &&visitor) const;
+
+    /**
+     * Query prefix tree for the highest scored words that match a given prefix. Words with
+     * the same score are returned in lexicographic order. Only available for trees with
+     * scores.
+     *
+     * @param prefix A given prefix.
+     * @param k Maximum number of words to return.
+     *
+     * @return A vector with at most k words and their scores, in decreasing order of score.
+     */
+    template <typename T = TScore>
+    std::vector<std::pair<string_type, std::enable_if_t<!std::is_void_v<T>, T>>>
+    topK(const string_type &prefix, size_t k) const;
+
+    /**
+     * Query prefix tree for all words within a given edit (Levenshtein) distance of a word.
+     * The tree is walked computing one row of the edit distance table per node, and subtrees
+     * are pruned as soon as every entry of the row exceeds the bound.
+     *
+     * @param word A given word.
+     * @param maxEdits Maximum number of insertions, deletions and substitutions.
+     *
+     * @return A vector with all the words within the distance, in lexicographic order.
+     */
+    std::vector<string_type> fuzzyQuery(const string_type &word, size_t maxEdits) const;
+
   private:
-    struct Node;
+    using key_type = std::make_unsigned_t<symbol_type>;
+
+    static constexpr bool isByteSymbol = sizeof(symbol_type) == 1;
+
+    enum class NodeKind : uint8_t { Node4, Node16, Node48, Node256, NodeN };
+
+    static constexpr bool hasScores = !std::is_void_v<TScore>;
+
+    using Scores = PrefixTreeScores<TScore>;
+
+    struct Node : Scores {
+        NodeKind kind;
+        bool isWordEnd;
+        uint32_t numChildren;
+
+        explicit Node(NodeKind k) : kind(k), isWordEnd(false), numChildren(0) {}
+    };
+
+    /// Slots of the nodes along the path to a word, and the key that leads out of each
+    using Path = std::vector<std::pair<key_type, Node **>>;
+
+    template <size_t Capacity> struct SortedNode : Node {
+        static constexpr uint32_t capacity = Capacity;
+
+        key_type keys[Capacity];
+        Node *children[Capacity];
+
+        SortedNode() : Node(Capacity == 4 ? NodeKind::Node4 : NodeKind::Node16) {}
+    };
+
+    using Node4 = SortedNode<4>;
+    using Node16 = SortedNode<16>;
+
+    /// Only used with byte symbols
+    struct Node48 : Node {
+        static constexpr uint32_t capacity = 48;
+
+        uint8_t childIndex[256]; /// Index into children plus one, or zero if there is no child
+        Node *children[48];
+
+        Node48() : Node(NodeKind::Node48) {
+            std::fill(std::begin(childIndex), std::end(childIndex), 0);
+            std::fill(std::begin(children), std::end(children), nullptr);
+        }
+    };
+
+    /// Only used with byte symbols
+    struct Node256 : Node {
+        Node *children[256];
+
+        Node256() : Node(NodeKind::Node256) {
+            std::fill(std::begin(children), std::end(children), nullptr);
+        }
+    };
+
+    /// Only used with wider symbols. Its children and keys are stored right after it, in the
+    /// same allocation, and it is reallocated with twice the capacity when full.
+    struct NodeN : Node {
+        uint32_t capacity;
+        Node **children;
+        key_type *keys;
+
+        explicit NodeN(uint32_t c)
+            : Node(NodeKind::NodeN), capacity(c), children(reinterpret_cast<Node **>(this + 1)),
+              keys(reinterpret_cast<key_type *>(children + c)) {}
+
+        static size_t allocationSize(uint32_t c) {
+            return sizeof(NodeN) + c * (sizeof(Node *) + sizeof(key_type));
+        }
+    };
+
+    /// Capacity of a NodeN when a Node16 grows into it
+    static constexpr uint32_t minNodeNCapacity = 32;
+
+    static constexpr size_t numNodeKinds = 5;
+
+    /// The allocator of the nodes, and the usage of the nodes of every kind it holds
+    struct NodeStore {
+        TAllocator allocator;
+        NodeUsage usage[numNodeKinds]; /// Indexed by NodeKind
+
+        /**
+         * Takes over the nodes of another store, which is left empty.
+         */
+        void merge(NodeStore &other) {
+            allocator.merge(other.allocator);
+
+            for (size_t kind = 0; kind < numNodeKinds; ++kind) {
+                usage[kind].numNodes += other.usage[kind].numNodes;
+                usage[kind].bytes += other.usage[kind].bytes;
+                other.usage[kind] = NodeUsage();
+            }
+        }
+    };
+
+    /**
+     * Returns a pointer to the slot that holds the child of a node for a given key.
+     *
+     * @return The slot, or nullptr if the node has no such child.
+     */
+    static Node **findChild(Node *node, key_type key);
 
-    std::unique_ptr<Node> m_root;
+    /**
+     * Calls a function with the key and the node of every child of a node, in increasing
+     * order of keys. If the function returns bool, the iteration stops when it returns false.
+     *
+     * @return false if the iteration was stopped, otherwise true.
+     */
+    template <typename TFunction> static bool forEachChild(const Node *node, TFunction &&function);
+
+    template <typename TFunction, typename TNode>
+    static bool invokeChild(TFunction &function, key_type key, TNode *child) {
+        if constexpr (std::is_same_v<std::invoke_result_t<TFunction &, key_type, TNode *>, bool>) {
+            return function(key, child);
+        } else {
+            function(key, child);
+            return true;
+        }
+    }
+
+    /**
+     * Returns the keys of a node of a sorted kind (Node4, Node16 or NodeN).
+     */
+    static key_type *sortedKeys(Node *node);
+
+    /**
+     * Returns the children of a node of a sorted kind (Node4, Node16 or NodeN).
+     */
+    static Node **sortedChildren(Node *node);
+
+    /**
+     * Adds a new empty child to a node, which is reallocated into a larger kind if full.
+     *
+     * @param slot Slot that holds the node; it is updated if the node is reallocated.
+     * @param key Key of the child, which must not be present.
+     *
+     * @return The new child.
+     */
+    static Node *addChild(NodeStore &store, Node *&slot, key_type key);
+
+    /**
+     * Removes and destroys a childless child of a node, which is reallocated into a smaller
+     * kind if underfull.
+     *
+     * @param slot Slot that holds the node; it is updated if the node is reallocated.
+     * @param key Key of the child, which must be present.
+     */
+    static void removeChild(NodeStore &store, Node *&slot, key_type key);
+
+    /**
+     * Reallocates a node into a node of a given kind, moving its children.
+     *
+     * @param capacity Capacity of the new node, if it is a NodeN.
+     */
+    static Node *reallocateNode(NodeStore &store, Node *node, NodeKind kind,
+                                uint32_t capacity = minNodeNCapacity);
+
+    /**
+     * Appends a child to a node with room for it. For sorted kinds, its key must be larger
+     * than all the present keys.
+     */
+    static void appendChild(Node *node, key_type key, Node *child);
+
+    static size_t nodeSize(NodeKind kind, uint32_t capacity);
+    static Node *createNode(NodeStore &store, NodeKind kind,
+                            uint32_t capacity = minNodeNCapacity);
+    static void destroyNode(NodeStore &store, Node *node);
+
+    /**
+     * Destroys a node and all its descendants, without recursion.
+     */
+    static void destroyTree(NodeStore &store, Node *node);
+
+    /**
+     * Builds the subtree of a sorted range of words that share their first depth symbols.
+     *
+     * @param numWords Set to the number of distinct words in the range.
+     *
+     * @return The root of the subtree.
+     */
+    static Node *buildSubtree(NodeStore &store, const string_type *const *begin,
+                              const string_type *const *end, size_t depth, size_t &numWords);
+
+    /**
+     * Finds the node of a word, recording the path to it.
+     *
+     * @return The node, or nullptr if the word is not a path in the tree.
+     */
+    Node *findPath(const string_type &word, Path &path) const;
+
+    /**
+     * Adds the nodes of a word that are missing, recording the path to it.
+     *
+     * @return The node of the word.
+     */
+    Node *insertPath(const string_type &word, Path &path);
+
+    /**
+     * Recomputes the highest subtree scores of a node and of its ancestors in a path, after
+     * a score in the subtree changed. Does nothing in trees without scores.
+     */
+    static void updateMaxScores(Node *node, const Path &path);
+
+    /**
+     * Visits the words under a node in lexicographic order. The buffer holds the word that
+     * leads to the node, and is restored before returning.
+     *
+     * @return false if the visitor stopped the walk, otherwise true.
+     */
+    template <typename TVisitor>
+    static bool visit(const Node *node, string_type &buffer, TVisitor &visitor);
+
+    /**
+     * Collects the words under a node within an edit distance of a word.
+     *
+     * @param rows Edit distance table, one row per symbol in the buffer plus the first row.
+     * @param buffer The word that leads to the node.
+     */
+    static void fuzzyCollect(const Node *node, const string_type &word, size_t maxEdits,
+                             std::vector<size_t> &rows, string_type &buffer,
+                             std::vector<string_type> &result);
+
+    NodeStore m_nodes;
+    Node *m_root;
     size_t m_size;
 };
 
-template <typename TString> struct PrefixTree<TString>::Node {
-    bool isWordEnd;
-    std::map<symbol_type, std::unique_ptr<Node>> children;
+template <typename TString, typename TAllocator, typename TScore>
+PrefixTree<TString, TAllocator, TScore>::PrefixTree()
+    : m_nodes(), m_root(createNode(m_nodes, NodeKind::Node4)), m_size(0) {}
 
-    Node() : isWordEnd(false) {}
+template <typename TString, typename TAllocator, typename TScore>
+PrefixTree<TString, TAllocator, TScore>::PrefixTree(const std::vector<string_type> &words,
+                                                    size_t numThreads)
+    : m_nodes(), m_root(nullptr), m_size(0) {
+    std::vector<const string_type *> sorted;
 
-    std::vector<string_type> collect(const string_type &prefix) const {
-        std::vector<string_type> result;
+    sorted.reserve(words.size());
 
-        collect(prefix, string_type(), result);
+    for (const auto &word : words) {
+        if (!word.empty())
+            sorted.push_back(&word);
+    }
 
-        return result;
+    const auto lessWord = [](const string_type *a, const string_type *b) { return less(*a, *b); };
+
+    if (!std::is_sorted(sorted.begin(), sorted.end(), lessWord))
+        std::sort(sorted.begin(), sorted.end(), lessWord);
+
+    // Start of the words of every first symbol, and the end of the last ones
+    std::vector<size_t> groups;
+
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        if (i == 0 || sorted[i]->front() != sorted[i - 1]->front())
+            groups.push_back(i);
     }
 
-  private:
-    void collect(const string_type &prefix, const string_type &wordEnding,
-                 std::vector<string_type> &result) const {
-        if (isWordEnd) {
-            result.push_back(prefix + wordEnding);
+    groups.push_back(sorted.size());
+
+    const size_t numGroups = groups.size() - 1;
+    std::vector<Node *> subtrees(numGroups);
+    std::vector<size_t> subtreeSizes(numGroups);
+
+    const auto buildGroups = [&](NodeStore &store, size_t first, size_t last) {
+        for (size_t group = first; group < last; ++group) {
+            subtrees[group] = buildSubtree(store, sorted.data() + groups[group],
+                                           sorted.data() + groups[group + 1], 1,
+                                           subtreeSizes[group]);
         }
+    };
+
+    numThreads = std::max(static_cast<size_t>(1), std::min(numThreads, numGroups));
+
+    if (numThreads == 1) {
+        buildGroups(m_nodes, 0, numGroups);
+    } else {
+        // Runs of consecutive groups with about the same number of words, each built with its
+        // own allocator, whose memory the tree takes over afterwards
+        std::vector<NodeStore> stores(numThreads);
+        std::vector<std::thread> threads;
+        size_t first = 0;
+
+        for (size_t thread = 1; thread <= numThreads && first < numGroups; ++thread) {
+            size_t last = first + 1;
+
+            while (last < numGroups && groups[last] < sorted.size() * thread / numThreads)
+                ++last;
+
+            if (thread == numThreads)
+                last = numGroups;
 
-        for (const auto &[symbol, child] : children) {
-            child->collect(prefix, wordEnding + symbol, result);
+            threads.emplace_back(buildGroups, std::ref(stores[thread - 1]), first, last);
+            first = last;
         }
+
+        for (auto &thread : threads)
+            thread.join();
+
+        for (auto &store : stores)
+            m_nodes.merge(store);
     }
-};
 
-template <typename TString>
-PrefixTree<TString>::PrefixTree() : m_root(std::make_unique<Node>()), m_size(0) {}
+    const NodeKind kind = numGroups <= Node4::capacity    ? NodeKind::Node4
+                          : numGroups <= Node16::capacity ? NodeKind::Node16
+                          : !isByteSymbol                 ? NodeKind::NodeN
+                          : numGroups <= Node48::capacity ? NodeKind::Node48
+                                                          : NodeKind::Node256;
 
-template <typename TString>
-PrefixTree<TString>::PrefixTree(const std::vector<string_type> &words)
-    : m_root(std::make_unique<Node>()), m_size(0) {
-    for (const auto &word : words) {
-        add(word);
+    m_root = createNode(m_nodes, kind, static_cast<uint32_t>(numGroups));
+
+    for (size_t group = 0; group < numGroups; ++group) {
+        appendChild(m_root, static_cast<key_type>(sorted[groups[group]]->front()),
+                    subtrees[group]);
+
+        if constexpr (hasScores)
+            m_root->maxScore = std::max(m_root->maxScore, subtrees[group]->maxScore);
+
+        m_size += subtreeSizes[group];
     }
 }
 
-template <typename TString> bool PrefixTree<TString>::add(const string_type &word) {
+template <typename TString, typename TAllocator, typename TScore>
+PrefixTree<TString, TAllocator, TScore>::PrefixTree(PrefixTree &&other)
+    : m_nodes(std::move(other.m_nodes)), m_root(other.m_root), m_size(other.m_size) {
+    other.m_nodes = NodeStore();
+    other.m_root = createNode(other.m_nodes, NodeKind::Node4);
+    other.m_size = 0;
+}
+
+template <typename TString, typename TAllocator, typename TScore>
+PrefixTree<TString, TAllocator, TScore> &
+PrefixTree<TString, TAllocator, TScore>::operator=(PrefixTree &&other) noexcept {
+    std::swap(m_nodes, other.m_nodes);
+    std::swap(m_root, other.m_root);
+    std::swap(m_size, other.m_size);
+    return *this;
+}
+
+template <typename TString, typename TAllocator, typename TScore>
+PrefixTree<TString, TAllocator, TScore>::~PrefixTree() {
+    // Otherwise the allocator frees all the nodes at once
+    if (m_root && !TAllocator::ownsAllMemory)
+        destroyTree(m_nodes, m_root);
+}
+
+template <typename TString, typename TAllocator, typename TScore>
+bool PrefixTree<TString, TAllocator, TScore>::add(const string_type &word) {
     if (word.empty())
         return false;
 
-    Node *node = m_root.get();
+    Path path;
+    Node *node = insertPath(word, path);
 
-    for (const symbol_type symbol : word) {
-        const auto it = node->children.find(symbol);
+    if (node->isWordEnd)
+        return false;
 
-        if (it == node->children.end())
-            node->children[symbol] = std::make_unique<Node>();
+    ++m_size;
+    node->isWordEnd = true;
 
-        node = node->children[symbol].get();
+    if constexpr (hasScores) {
+        node->score = TScore();
+        updateMaxScores(node, path);
     }
 
+    return true;
+}
+
+template <typename TString, typename TAllocator, typename TScore>
+template <typename T>
+bool PrefixTree<TString, TAllocator, TScore>::add(const string_type &word,
+                                                  std::enable_if_t<!std::is_void_v<T>, T> score) {
+    if (word.empty())
+        return false;
+
+    Path path;
+    Node *node = insertPath(word, path);
+
     if (node->isWordEnd)
         return false;
 
     ++m_size;
     node->isWordEnd = true;
+    node->score = score;
+    updateMaxScores(node, path);
 
     return true;
 }
 
-template <typename TString> bool PrefixTree<TString>::remove(const string_type &word) {
-    if (word.empty())
+template <typename TString, typename TAllocator, typename TScore>
+template <typename T>
+bool PrefixTree<TString, TAllocator, TScore>::setScore(
+    const string_type &word, std::enable_if_t<!std::is_void_v<T>, T> score) {
+    Path path;
+    Node *node = findPath(word, path);
+
+    if (node == nullptr || !node->isWordEnd)
         return false;
 
-    std::stack<std::pair<symbol_type, Node *>> path;
-    Node *node = m_root.get();
+    node->score = score;
+    updateMaxScores(node, path);
 
-    for (const symbol_type symbol : word) {
-        const auto it = node->children.find(symbol);
+    return true;
+}
+
+template <typename TString, typename TAllocator, typename TScore>
+bool PrefixTree<TString, TAllocator, TScore>::remove(const string_type &word) {
+    Path path;
+    Node *node = findPath(word, path);
 
-        if (it == node->children.end() || it->second == nullptr)
-            return false;
+    if (node == nullptr || !node->isWordEnd)
+        return false;
+
+    Node **slot = findChild(*path.back().second, path.back().first);
+
+    node->isWordEnd = false;
+
+    // Prune the nodes that no longer lead to any word
+    while (!path.empty() && (*slot)->numChildren == 0 && !(*slot)->isWordEnd) {
+        const auto [key, parentSlot] = path.back();
+
+        path.pop_back();
+        removeChild(m_nodes, *parentSlot, key);
+        slot = parentSlot;
+    }
+
+    updateMaxScores(*slot, path);
+    --m_size;
+
+    return true;
+}
+
+template <typename TString, typename TAllocator, typename TScore>
+std::vector<TString>
+PrefixTree<TString, TAllocator, TScore>::query(const string_type &prefix) const {
+    return query(prefix, std::numeric_limits<size_t>::max());
+}
 
-        path.push(std::make_pair(symbol, node));
+template <typename TString, typename TAllocator, typename TScore>
+std::vector<TString> PrefixTree<TString, TAllocator, TScore>::query(const string_type &prefix,
+                                                                    size_t limit) const {
+    std::vector<string_type> result;
 
-        node = it->second.get();
+    if (prefix.empty() || limit == 0)
+        return result;
+
+    forEach(prefix, [&](const string_type &word) {
+        result.push_back(word);
+        return result.size() < limit;
+    });
+
+    return result;
+}
+
+template <typename TString, typename TAllocator, typename TScore>
+template <typename TVisitor>
+bool PrefixTree<TString, TAllocator, TScore>::forEach(const string_type &prefix,
+                                                      TVisitor &&visitor) const {
+    Node *node = m_root;
+
+    for (const symbol_type symbol : prefix) {
+        Node **childSlot = findChild(node, static_cast<key_type>(symbol));
+
+        if (childSlot == nullptr)
+            return true;
+
+        node = *childSlot;
     }
 
-    if (!node->isWordEnd)
+    string_type buffer = prefix;
+
+    return visit(node, buffer, visitor);
+}
+
+template <typename TString, typename TAllocator, typename TScore>
+template <typename TVisitor>
+bool PrefixTree<TString, TAllocator, TScore>::visit(const Node *node, string_type &buffer,
+                                                    TVisitor &visitor) {
+    if (node->isWordEnd && !visitor(static_cast<const string_type &>(buffer)))
         return false;
 
-    if (!node->children.empty()) {
-        node->isWordEnd = false;
-    } else {
-        while (!path.empty()) {
-            auto [symbol, node] = path.top();
+    return forEachChild(node, [&](key_type key, const Node *child) {
+        buffer.push_back(static_cast<symbol_type>(key));
+
+        const bool proceed = visit(child, buffer, visitor);
+
+        buffer.pop_back();
+
+        return proceed;
+    });
+}
+
+template <typename TString, typename TAllocator, typename TScore>
+template <typename T>
+std::vector<std::pair<TString, std::enable_if_t<!std::is_void_v<T>, T>>>
+PrefixTree<TString, TAllocator, TScore>::topK(const string_type &prefix, size_t k) const {
+    if (prefix.empty() || k == 0)
+        return {};
+
+    Path path;
+    const Node *node = findPath(prefix, path);
+
+    if (node == nullptr)
+        return {};
+
+    // Best-first search. A subtree enters the queue with its highest score, which bounds the
+    // score of every word in it, and its words are not lexicographically smaller than its
+    // prefix, so words come out of the queue in the order of the result.
+    struct Candidate {
+        TScore score;
+        const Node *node; /// nullptr if the candidate is a word rather than a subtree
+        string_type word;
+
+        bool operator<(const Candidate &other) const {
+            if (score != other.score)
+                return score < other.score;
+
+            return less(other.word, word);
+        }
+    };
+
+    std::vector<std::pair<string_type, TScore>> result;
+    std::priority_queue<Candidate> candidates;
+
+    candidates.push(Candidate{node->maxScore, node, prefix});
+
+    while (!candidates.empty() && result.size() < k) {
+        Candidate candidate = candidates.top();
+
+        candidates.pop();
+
+        if (candidate.node == nullptr) {
+            result.emplace_back(std::move(candidate.word), candidate.score);
+            continue;
+        }
+
+        if (candidate.node->isWordEnd)
+            candidates.push(Candidate{candidate.node->score, nullptr, candidate.word});
+
+        forEachChild(candidate.node, [&](key_type key, const Node *child) {
+            candidates.push(
+                Candidate{child->maxScore, child, candidate.word + static_cast<symbol_type>(key)});
+        });
+    }
+
+    return result;
+}
+
+template <typename TString, typename TAllocator, typename TScore>
+std::vector<TString> PrefixTree<TString, TAllocator, TScore>::fuzzyQuery(const string_type &word,
+                                                                         size_t maxEdits) const {
+    std::vector<string_type> result;
+    std::vector<size_t> rows(word.size() + 1);
+    string_type buffer;
+
+    // Distance from the empty word
+    for (size_t j = 0; j <= word.size(); ++j)
+        rows[j] = j;
 
-            path.pop();
-            node->children.erase(symbol);
+    forEachChild(m_root, [&](key_type key, const Node *child) {
+        buffer.push_back(static_cast<symbol_type>(key));
+        fuzzyCollect(child, word, maxEdits, rows, buffer, result);
+        buffer.pop_back();
+    });
 
-            if (node->isWordEnd)
+    return result;
+}
+
+template <typename TString, typename TAllocator, typename TScore>
+void PrefixTree<TString, TAllocator, TScore>::fuzzyCollect(const Node *node,
+                                                           const string_type &word,
+                                                           size_t maxEdits,
+                                                           std::vector<size_t> &rows,
+                                                           string_type &buffer,
+                                                           std::vector<string_type> &result) {
+    const size_t width = word.size() + 1;
+    const size_t previous = (buffer.size() - 1) * width;
+    const size_t current = previous + width;
+    const symbol_type symbol = buffer.back();
+
+    rows.resize(current + width);
+    rows[current] = rows[previous] + 1;
+
+    size_t rowMin = rows[current];
+
+    for (size_t j = 1; j < width; ++j) {
+        const size_t substitution = rows[previous + j - 1] + (word[j - 1] != symbol);
+        const size_t edit = std::min(rows[previous + j], rows[current + j - 1]) + 1;
+
+        rows[current + j] = std::min(substitution, edit);
+        rowMin = std::min(rowMin, rows[current + j]);
+    }
+
+    // No word in the subtree can get closer than the closest entry of the row
+    if (rowMin > maxEdits)
+        return;
+
+    if (node->isWordEnd && rows[current + width - 1] <= maxEdits)
+        result.push_back(buffer);
+
+    forEachChild(node, [&](key_type key, const Node *child) {
+        buffer.push_back(static_cast<symbol_type>(key));
+        fuzzyCollect(child, word, maxEdits, rows, buffer, result);
+        buffer.pop_back();
+    });
+}
+
+template <typename TString, typename TAllocator, typename TScore>
+typename PrefixTree<TString, TAllocator, TScore>::Node *
+PrefixTree<TString, TAllocator, TScore>::findPath(const string_type &word, Path &path) const {
+    if (word.empty())
+        return nullptr;
+
+    Node **slot = const_cast<Node **>(&m_root);
+
+    for (const symbol_type symbol : word) {
+        const auto key = static_cast<key_type>(symbol);
+        Node **childSlot = findChild(*slot, key);
+
+        if (childSlot == nullptr)
+            return nullptr;
+
+        path.push_back(std::make_pair(key, slot));
+
+        slot = childSlot;
+    }
+
+    return *slot;
+}
+
+template <typename TString, typename TAllocator, typename TScore>
+typename PrefixTree<TString, TAllocator, TScore>::Node *
+PrefixTree<TString, TAllocator, TScore>::insertPath(const string_type &word, Path &path) {
+    Node **slot = &m_root;
+
+    for (const symbol_type symbol : word) {
+        const auto key = static_cast<key_type>(symbol);
+        Node **childSlot = findChild(*slot, key);
+
+        if (childSlot == nullptr) {
+            addChild(m_nodes, *slot, key);
+            childSlot = findChild(*slot, key);
+        }
+
+        path.push_back(std::make_pair(key, slot));
+
+        slot = childSlot;
+    }
+
+    return *slot;
+}
+
+template <typename TString, typename TAllocator, typename TScore>
+void PrefixTree<TString, TAllocator, TScore>::updateMaxScores(Node *node, const Path &path) {
+    if constexpr (hasScores) {
+        auto it = path.rbegin();
+
+        while (true) {
+            TScore maxScore = node->isWordEnd ? node->score : Scores::noScore;
+
+            forEachChild(node, [&maxScore](key_type, const Node *child) {
+                maxScore = std::max(maxScore, child->maxScore);
+            });
+
+            // The ancestors are up to date if this subtree did not change
+            if (maxScore == node->maxScore)
+                break;
+
+            node->maxScore = maxScore;
+
+            if (it == path.rend())
                 break;
+
+            node = *(it++)->second;
         }
     }
+}
 
-    --m_size;
+template <typename TString, typename TAllocator, typename TScore>
+typename PrefixTree<TString, TAllocator, TScore>::Node **
+PrefixTree<TString, TAllocator, TScore>::findChild(Node *node, key_type key) {
+    switch (node->kind) {
+    case NodeKind::Node4: {
+        auto *node4 = static_cast<Node4 *>(node);
+
+        for (uint32_t i = 0; i < node4->numChildren; ++i) {
+            if (node4->keys[i] == key)
+                return &node4->children[i];
+        }
+
+        return nullptr;
+    }
+    case NodeKind::Node16: {
+        auto *node16 = static_cast<Node16 *>(node);
+
+#if defined(__SSE2__)
+        if constexpr (isByteSymbol) {
+            const __m128i keys = _mm_loadu_si128(reinterpret_cast<const __m128i *>(node16->keys));
+            const __m128i matches = _mm_cmpeq_epi8(keys, _mm_set1_epi8(static_cast<char>(key)));
+            const int mask =
+                _mm_movemask_epi8(matches) & ((1 << node16->numChildren) - 1);
+
+            return mask != 0 ? &node16->children[__builtin_ctz(mask)] : nullptr;
+        }
+#endif
+
+        key_type *const end = node16->keys + node16->numChildren;
+        key_type *const it = std::lower_bound(node16->keys, end, key);
+
+        return it != end && *it == key ? &node16->children[it - node16->keys] : nullptr;
+    }
+    case NodeKind::Node48: {
+        auto *node48 = static_cast<Node48 *>(node);
+        const uint8_t index = node48->childIndex[key & 0xff];
+
+        return index != 0 ? &node48->children[index - 1] : nullptr;
+    }
+    case NodeKind::Node256: {
+        auto *node256 = static_cast<Node256 *>(node);
+
+        return node256->children[key & 0xff] != nullptr ? &node256->children[key & 0xff]
+                                                        : nullptr;
+    }
+    case NodeKind::NodeN: {
+        auto *nodeN = static_cast<NodeN *>(node);
+        key_type *const end = nodeN->keys + nodeN->numChildren;
+        key_type *const it = std::lower_bound(nodeN->keys, end, key);
+
+        return it != end && *it == key ? &nodeN->children[it - nodeN->keys] : nullptr;
+    }
+    }
+
+    return nullptr;
+}
+
+template <typename TString, typename TAllocator, typename TScore>
+template <typename TFunction>
+bool PrefixTree<TString, TAllocator, TScore>::forEachChild(const Node *node, TFunction &&function) {
+    switch (node->kind) {
+    case NodeKind::Node4: {
+        const auto *node4 = static_cast<const Node4 *>(node);
+
+        for (uint32_t i = 0; i < node4->numChildren; ++i) {
+            if (!invokeChild(function, node4->keys[i], node4->children[i]))
+                return false;
+        }
+
+        break;
+    }
+    case NodeKind::Node16: {
+        const auto *node16 = static_cast<const Node16 *>(node);
+
+        for (uint32_t i = 0; i < node16->numChildren; ++i) {
+            if (!invokeChild(function, node16->keys[i], node16->children[i]))
+                return false;
+        }
+
+        break;
+    }
+    case NodeKind::Node48: {
+        const auto *node48 = static_cast<const Node48 *>(node);
+
+        for (uint32_t key = 0; key < 256; ++key) {
+            if (node48->childIndex[key] != 0 &&
+                !invokeChild(function, static_cast<key_type>(key),
+                             node48->children[node48->childIndex[key] - 1]))
+                return false;
+        }
+
+        break;
+    }
+    case NodeKind::Node256: {
+        const auto *node256 = static_cast<const Node256 *>(node);
+
+        for (uint32_t key = 0; key < 256; ++key) {
+            if (node256->children[key] != nullptr &&
+                !invokeChild(function, static_cast<key_type>(key), node256->children[key]))
+                return false;
+        }
+
+        break;
+    }
+    case NodeKind::NodeN: {
+        const auto *nodeN = static_cast<const NodeN *>(node);
+
+        for (uint32_t i = 0; i < nodeN->numChildren; ++i) {
+            if (!invokeChild(function, nodeN->keys[i], nodeN->children[i]))
+                return false;
+        }
+
+        break;
+    }
+    }
 
     return true;
 }
 
-template <typename TString>
-std::vector<TString> PrefixTree<TString>::query(const string_type &prefix) const {
-    if (prefix.empty())
-        return {};
+template <typename TString, typename TAllocator, typename TScore>
+typename PrefixTree<TString, TAllocator, TScore>::key_type *
+PrefixTree<TString, TAllocator, TScore>::sortedKeys(Node *node) {
+    switch (node->kind) {
+    case NodeKind::Node4:
+        return static_cast<Node4 *>(node)->keys;
+    case NodeKind::Node16:
+        return static_cast<Node16 *>(node)->keys;
+    default:
+        return static_cast<NodeN *>(node)->keys;
+    }
+}
+
+template <typename TString, typename TAllocator, typename TScore>
+typename PrefixTree<TString, TAllocator, TScore>::Node **
+PrefixTree<TString, TAllocator, TScore>::sortedChildren(Node *node) {
+    switch (node->kind) {
+    case NodeKind::Node4:
+        return static_cast<Node4 *>(node)->children;
+    case NodeKind::Node16:
+        return static_cast<Node16 *>(node)->children;
+    default:
+        return static_cast<NodeN *>(node)->children;
+    }
+}
 
-    Node *node = m_root.get();
+template <typename TString, typename TAllocator, typename TScore>
+typename PrefixTree<TString, TAllocator, TScore>::Node *
+PrefixTree<TString, TAllocator, TScore>::addChild(NodeStore &store, Node *&slot, key_type key) {
+    Node *child = createNode(store, NodeKind::Node4);
+    Node *node = slot;
 
-    for (const symbol_type symbol : prefix) {
-        const auto it = node->children.find(symbol);
+    switch (node->kind) {
+    case NodeKind::Node4:
+        if (node->numChildren == Node4::capacity)
+            node = slot = reallocateNode(store, node, NodeKind::Node16);
+        break;
+    case NodeKind::Node16:
+        if (node->numChildren == Node16::capacity)
+            node = slot = reallocateNode(store, node,
+                                         isByteSymbol ? NodeKind::Node48 : NodeKind::NodeN);
+        break;
+    case NodeKind::Node48:
+        if (node->numChildren == Node48::capacity)
+            node = slot = reallocateNode(store, node, NodeKind::Node256);
+        break;
+    case NodeKind::NodeN: {
+        const uint32_t capacity = static_cast<NodeN *>(node)->capacity;
+
+        if (node->numChildren == capacity)
+            node = slot = reallocateNode(store, node, NodeKind::NodeN, 2 * capacity);
+        break;
+    }
+    case NodeKind::Node256:
+        break;
+    }
+
+    switch (node->kind) {
+    case NodeKind::Node4:
+    case NodeKind::Node16:
+    case NodeKind::NodeN: {
+        key_type *keys = sortedKeys(node);
+        Node **children = sortedChildren(node);
+        const uint32_t position = std::lower_bound(keys, keys + node->numChildren, key) - keys;
+
+        std::move_backward(keys + position, keys + node->numChildren,
+                           keys + node->numChildren + 1);
+        std::move_backward(children + position, children + node->numChildren,
+                           children + node->numChildren + 1);
+        keys[position] = key;
+        children[position] = child;
+        ++node->numChildren;
+        break;
+    }
+    case NodeKind::Node48:
+    case NodeKind::Node256:
+        appendChild(node, key, child);
+        break;
+    }
+
+    return child;
+}
+
+template <typename TString, typename TAllocator, typename TScore>
+void PrefixTree<TString, TAllocator, TScore>::removeChild(NodeStore &store, Node *&slot,
+                                                          key_type key) {
+    Node *node = slot;
+
+    switch (node->kind) {
+    case NodeKind::Node4:
+    case NodeKind::Node16:
+    case NodeKind::NodeN: {
+        key_type *keys = sortedKeys(node);
+        Node **children = sortedChildren(node);
+        const uint32_t position = std::lower_bound(keys, keys + node->numChildren, key) - keys;
+
+        destroyNode(store, children[position]);
+        std::move(keys + position + 1, keys + node->numChildren, keys + position);
+        std::move(children + position + 1, children + node->numChildren, children + position);
+        --node->numChildren;
+
+        if (node->kind == NodeKind::Node16 && node->numChildren <= 3)
+            slot = reallocateNode(store, node, NodeKind::Node4);
+        else if (node->kind == NodeKind::NodeN && node->numChildren <= 12)
+            slot = reallocateNode(store, node, NodeKind::Node16);
+        break;
+    }
+    case NodeKind::Node48: {
+        auto *node48 = static_cast<Node48 *>(node);
+        const uint8_t index = node48->childIndex[key & 0xff];
 
-        if (it == node->children.end() || it->second == nullptr)
-            return {};
+        destroyNode(store, node48->children[index - 1]);
+        node48->children[index - 1] = nullptr;
+        node48->childIndex[key & 0xff] = 0;
+        --node->numChildren;
 
-        node = it->second.get();
+        if (node->numChildren <= 12)
+            slot = reallocateNode(store, node, NodeKind::Node16);
+        break;
     }
+    case NodeKind::Node256: {
+        auto *node256 = static_cast<Node256 *>(node);
 
-    return node->collect(prefix);
+        destroyNode(store, node256->children[key & 0xff]);
+        node256->children[key & 0xff] = nullptr;
+        --node->numChildren;
+
+        if (node->numChildren <= 37)
+            slot = reallocateNode(store, node, NodeKind::Node48);
+        break;
+    }
+    }
+}
+
+template <typename TString, typename TAllocator, typename TScore>
+typename PrefixTree<TString, TAllocator, TScore>::Node *
+PrefixTree<TString, TAllocator, TScore>::reallocateNode(NodeStore &store, Node *node, NodeKind kind,
+                                                        uint32_t capacity) {
+    Node *newNode = createNode(store, kind, capacity);
+    newNode->isWordEnd = node->isWordEnd;
+    static_cast<Scores &>(*newNode) = static_cast<const Scores &>(*node);
+
+    forEachChild(node, [newNode](key_type key, Node *child) { appendChild(newNode, key, child); });
+
+    // The children now belong to the new node
+    node->numChildren = 0;
+    destroyNode(store, node);
+
+    return newNode;
+}
+
+template <typename TString, typename TAllocator, typename TScore>
+void PrefixTree<TString, TAllocator, TScore>::appendChild(Node *node, key_type key, Node *child) {
+    switch (node->kind) {
+    case NodeKind::Node4:
+    case NodeKind::Node16:
+    case NodeKind::NodeN:
+        sortedKeys(node)[node->numChildren] = key;
+        sortedChildren(node)[node->numChildren] = child;
+        break;
+    case NodeKind::Node48: {
+        auto *node48 = static_cast<Node48 *>(node);
+        uint8_t index = 0;
+
+        while (node48->children[index] != nullptr)
+            ++index;
+
+        node48->children[index] = child;
+        node48->childIndex[key & 0xff] = index + 1;
+        break;
+    }
+    case NodeKind::Node256:
+        static_cast<Node256 *>(node)->children[key & 0xff] = child;
+        break;
+    }
+
+    ++node->numChildren;
+}
+
+template <typename TString, typename TAllocator, typename TScore>
+typename PrefixTree<TString, TAllocator, TScore>::Node *
+PrefixTree<TString, TAllocator, TScore>::buildSubtree(
+    NodeStore &store, const string_type *const *begin, const string_type *const *end,
+    size_t depth, size_t &numWords) {
+    Node *root = createNode(store, NodeKind::Node4);
+    std::vector<Node **> path{&root};
+    const string_type *previous = nullptr;
+
+    // Every word added in bulk has the default score
+    if constexpr (hasScores)
+        root->maxScore = TScore();
+
+    numWords = 0;
+
+    for (auto it = begin; it != end; ++it) {
+        const string_type &word = **it;
+        size_t shared = depth;
+
+        if (previous != nullptr) {
+            const size_t length = std::min(previous->size(), word.size());
+
+            while (shared < length && (*previous)[shared] == word[shared])
+                ++shared;
+
+            if (shared == word.size() && shared == previous->size())
+                continue;
+        }
+
+        // Only the last node of the shared path can grow, so the slots in the path stay valid
+        path.resize(shared - depth + 1);
+
+        for (size_t i = shared; i < word.size(); ++i) {
+            const auto key = static_cast<key_type>(word[i]);
+            Node *&slot = *path.back();
+
+            addChild(store, slot, key);
+            path.push_back(findChild(slot, key));
+
+            if constexpr (hasScores)
+                (*path.back())->maxScore = TScore();
+        }
+
+        (*path.back())->isWordEnd = true;
+        ++numWords;
+        previous = &word;
+    }
+
+    return root;
+}
+
+template <typename TString, typename TAllocator, typename TScore>
+size_t PrefixTree<TString, TAllocator, TScore>::nodeSize(NodeKind kind, uint32_t capacity) {
+    switch (kind) {
+    case NodeKind::Node4:
+        return sizeof(Node4);
+    case NodeKind::Node16:
+        return sizeof(Node16);
+    case NodeKind::Node48:
+        return sizeof(Node48);
+    case NodeKind::Node256:
+        return sizeof(Node256);
+    case NodeKind::NodeN:
+        return NodeN::allocationSize(capacity);
+    }
+
+    return 0;
+}
+
+template <typename TString, typename TAllocator, typename TScore>
+typename PrefixTree<TString, TAllocator, TScore>::Node *
+PrefixTree<TString, TAllocator, TScore>::createNode(NodeStore &store, NodeKind kind,
+                                                    uint32_t capacity) {
+    const size_t size = nodeSize(kind, capacity);
+    void *memory = store.allocator.allocate(size);
+    NodeUsage &usage = store.usage[static_cast<size_t>(kind)];
+
+    ++usage.numNodes;
+    usage.bytes += size;
+
+    switch (kind) {
+    case NodeKind::Node4:
+        return new (memory) Node4();
+    case NodeKind::Node16:
+        return new (memory) Node16();
+    case NodeKind::Node48:
+        return new (memory) Node48();
+    case NodeKind::Node256:
+        return new (memory) Node256();
+    case NodeKind::NodeN:
+        return new (memory) NodeN(capacity);
+    }
+
+    return nullptr;
+}
+
+template <typename TString, typename TAllocator, typename TScore>
+void PrefixTree<TString, TAllocator, TScore>::destroyNode(NodeStore &store, Node *node) {
+    // All the node kinds are trivially destructible
+    const uint32_t capacity =
+        node->kind == NodeKind::NodeN ? static_cast<NodeN *>(node)->capacity : 0;
+
+    const size_t size = nodeSize(node->kind, capacity);
+    NodeUsage &usage = store.usage[static_cast<size_t>(node->kind)];
+
+    --usage.numNodes;
+    usage.bytes -= size;
+    store.allocator.deallocate(node, size);
+}
+
+template <typename TString, typename TAllocator, typename TScore>
+void PrefixTree<TString, TAllocator, TScore>::destroyTree(NodeStore &store, Node *node) {
+    std::vector<Node *> pending{node};
+
+    while (!pending.empty()) {
+        Node *current = pending.back();
+
+        pending.pop_back();
+        forEachChild(current, [&pending](key_type, Node *child) { pending.push_back(child); });
+        destroyNode(store, current);
+    }
 }
 
-} // namespace cake
\ No newline at end of file
+} // namespace cake
@@ -0,0 +1,335 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cake {
+
+/**
+ * Radix Tree data structure. A path-compressed prefix tree: chains of nodes with a single
+ * child are merged into one edge labelled with the whole span of symbols, so the tree has at
+ * most two nodes per word regardless of word length, and a lookup compares whole spans at
+ * once. Same interface and results as PrefixTree.
+ */
+template <typename TString> class RadixTree {
+  public:
+    using string_type = TString;
+    using symbol_type = typename TString::value_type;
+
+    /**
+     * Constructor. Creates an empty radix tree.
+     */
+    RadixTree();
+
+    /**
+     * Constructor. Creates a radix tree with all the words in a given vector.
+     *
+     * @param words Container of words.
+     */
+    RadixTree(const std::vector<string_type> &words);
+
+    /** Returns how many words the radix tree contains.
+     *
+     * @return The number of words in the radix tree.
+     */
+    size_t size() const { return m_size; }
+
+    /** Returns how many nodes the radix tree has, including the root.
+     *
+     * @return The number of nodes in the radix tree.
+     */
+    size_t numNodes() const { return m_numNodes; }
+
+    /**
+     * Returns an estimate of the memory used by the radix tree: the tree object, the nodes,
+     * the pointers to them, and the symbols of the labels. It is kept up to date as nodes are
+     * added and removed, so this takes constant time.
+     *
+     * @return The number of bytes.
+     */
+    size_t memoryUsage() const {
+        return sizeof(*this) + m_numNodes * sizeof(Node) +
+               (m_numNodes - 1) * sizeof(std::unique_ptr<Node>) +
+               m_numLabelSymbols * sizeof(symbol_type);
+    }
+
+    /**
+     * Add a new word to the radix tree, if the word was not already present.
+     *
+     * @param word Given word.
+     *
+     * @return true if the new word is not empty and was not already present, otherwise false.
+     */
+    bool add(const string_type &word);
+
+    /**
+     * Remove a word from the radix tree.
+     *
+     * @param word Given word.
+     *
+     * @return true if the word was removed, otherwise false.
+     */
+    bool remove(const string_type &word);
+
+    /**
+     * Query radix tree for all words that match a given prefix.
+     *
+     * @param prefix A given prefix.
+     *
+     * @return A vector with all the words in the radix tree that match the given prefix, in
+     * the same order as PrefixTree::query.
+     */
+    std::vector<string_type> query(const string_type &prefix) const;
+
+  private:
+    using key_type = std::make_unsigned_t<symbol_type>;
+
+    struct Node {
+        string_type label; /// Symbols on the edge from the parent; empty only for the root
+        bool isWordEnd;
+        std::vector<std::unique_ptr<Node>> children; /// Sorted by first symbol of their label
+
+        Node(string_type l, bool wordEnd) : label(std::move(l)), isWordEnd(wordEnd) {}
+
+        key_type firstKey() const { return static_cast<key_type>(label.front()); }
+
+        /**
+         * Returns the position of the child whose label starts with a given symbol, or the
+         * position where it would be inserted.
+         */
+        size_t childPosition(symbol_type symbol) const {
+            const auto key = static_cast<key_type>(symbol);
+            const auto it = std::lower_bound(children.begin(), children.end(), key,
+                                             [](const std::unique_ptr<Node> &child, key_type k) {
+                                                 return child->firstKey() < k;
+                                             });
+
+            return it - children.begin();
+        }
+
+        /**
+         * Returns the child whose label starts with a given symbol, or nullptr if none.
+         */
+        Node *findChild(symbol_type symbol) const {
+            const size_t position = childPosition(symbol);
+
+            if (position == children.size() ||
+                children[position]->firstKey() != static_cast<key_type>(symbol))
+                return nullptr;
+
+            return children[position].get();
+        }
+    };
+
+    /**
+     * Returns the length of the common prefix of a label and the suffix of a word starting at
+     * a given position.
+     */
+    static size_t commonPrefixLength(const string_type &label, const string_type &word,
+                                     size_t position) {
+        const size_t length = std::min(label.size(), word.size() - position);
+        const auto mismatch =
+            std::mismatch(label.begin(), label.begin() + length, word.begin() + position);
+
+        return mismatch.first - label.begin();
+    }
+
+    /**
+     * Merges a node that is not a word end with its only child.
+     */
+    void mergeWithChild(Node *node);
+
+    static void collect(const Node *node, string_type &buffer, std::vector<string_type> &result);
+
+    std::unique_ptr<Node> m_root;
+    size_t m_size;
+    size_t m_numNodes;
+    size_t m_numLabelSymbols; /// Total length of the labels of all the nodes
+};
+
+template <typename TString>
+RadixTree<TString>::RadixTree()
+    : m_root(std::make_unique<Node>(string_type(), false)), m_size(0), m_numNodes(1),
+      m_numLabelSymbols(0) {}
+
+template <typename TString>
+RadixTree<TString>::RadixTree(const std::vector<string_type> &words) : RadixTree() {
+    for (const auto &word : words) {
+        add(word);
+    }
+}
+
+template <typename TString> bool RadixTree<TString>::add(const string_type &word) {
+    if (word.empty())
+        return false;
+
+    Node *node = m_root.get();
+    size_t position = 0;
+
+    while (position < word.size()) {
+        const size_t childPosition = node->childPosition(word[position]);
+        auto &children = node->children;
+
+        if (childPosition == children.size() ||
+            children[childPosition]->firstKey() != static_cast<key_type>(word[position])) {
+            children.insert(children.begin() + childPosition,
+                            std::make_unique<Node>(word.substr(position), true));
+            ++m_numNodes;
+            ++m_size;
+            m_numLabelSymbols += word.size() - position;
+            return true;
+        }
+
+        Node *child = children[childPosition].get();
+        const size_t length = commonPrefixLength(child->label, word, position);
+
+        if (length < child->label.size()) {
+            // Split the edge at the mismatch
+            auto middle = std::make_unique<Node>(child->label.substr(0, length), false);
+            child->label.erase(0, length);
+            middle->children.push_back(std::move(children[childPosition]));
+            children[childPosition] = std::move(middle);
+            child = children[childPosition].get();
+            ++m_numNodes;
+        }
+
+        node = child;
+        position += length;
+    }
+
+    if (node->isWordEnd)
+        return false;
+
+    node->isWordEnd = true;
+    ++m_size;
+
+    return true;
+}
+
+template <typename TString> bool RadixTree<TString>::remove(const string_type &word) {
+    if (word.empty())
+        return false;
+
+    Node *parent = nullptr;
+    Node *node = m_root.get();
+    size_t position = 0;
+
+    while (position < word.size()) {
+        Node *child = node->findChild(word[position]);
+
+        if (child == nullptr)
+            return false;
+
+        const size_t length = commonPrefixLength(child->label, word, position);
+
+        if (length < child->label.size())
+            return false;
+
+        parent = node;
+        node = child;
+        position += length;
+    }
+
+    if (!node->isWordEnd)
+        return false;
+
+    node->isWordEnd = false;
+    --m_size;
+
+    if (node->children.size() == 1) {
+        mergeWithChild(node);
+    } else if (node->children.empty()) {
+        m_numLabelSymbols -= node->label.size();
+        parent->children.erase(parent->children.begin() + parent->childPosition(node->label[0]));
+        --m_numNodes;
+
+        if (parent != m_root.get() && !parent->isWordEnd && parent->children.size() == 1)
+            mergeWithChild(parent);
+    }
+
+    return true;
+}
+
+template <typename TString>
+std::vector<TString> RadixTree<TString>::query(const string_type &prefix) const {
+    if (prefix.empty())
+        return {};
+
+    const Node *node = m_root.get();
+    size_t position = 0;
+    string_type buffer;
+
+    while (position < prefix.size()) {
+        const Node *child = node->findChild(prefix[position]);
+
+        if (child == nullptr)
+            return {};
+
+        const size_t length = commonPrefixLength(child->label, prefix, position);
+
+        if (position + length < prefix.size() && length < child->label.size())
+            return {};
+
+        buffer += child->label;
+        node = child;
+        position += length;
+    }
+
+    std::vector<string_type> result;
+
+    collect(node, buffer, result);
+
+    return result;
+}
+
+template <typename TString> void RadixTree<TString>::mergeWithChild(Node *node) {
+    std::unique_ptr<Node> child = std::move(node->children.front());
+
+    node->label += child->label;
+    node->isWordEnd = child->isWordEnd;
+    node->children = std::move(child->children);
+    --m_numNodes;
+}
+
+template <typename TString>
+void RadixTree<TString>::collect(const Node *node, string_type &buffer,
+                                 std::vector<string_type> &result) {
+    if (node->isWordEnd)
+        result.push_back(buffer);
+
+    for (const auto &child : node->children) {
+        buffer += child->label;
+        collect(child.get(), buffer, result);
+        buffer.resize(buffer.size() - child->label.size());
+    }
+}
+
+} // namespace cake
@@ -0,0 +1,203 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace cake {
+
+/**
+ * Disjoint Set of the dense integer elements 0, 1, ..., size() - 1, whose merges can be
+ * undone. Like DenseDisjointSet, a single array holds the parent of every element, or minus
+ * the size of its set for roots. Sets are linked by size and paths are never compressed, so
+ * every merge changes exactly two entries, which are recorded in a log. find takes
+ * logarithmic time.
+ *
+ * checkpoint() marks the current state, and rollback() undoes the merges since a checkpoint,
+ * in time proportional to their number.
+ */
+template <typename TElement> class RollbackDisjointSet {
+    static_assert(std::is_integral_v<TElement> && std::is_signed_v<TElement>,
+                  "Elements must be of a signed integer type");
+
+  public:
+    using element_type = TElement;
+
+    /// State to roll back to, as the number of merges done before it
+    using Checkpoint = size_t;
+
+    /**
+     * Constructor. Creates a disjoint set with a given number of elements, each in its own
+     * set.
+     *
+     * @param numElements Number of elements.
+     */
+    explicit RollbackDisjointSet(size_t numElements = 0)
+        : m_entries(numElements, -1), m_numSets(numElements) {}
+
+    /**
+     * Returns the number of elements.
+     *
+     * @return The number of elements.
+     */
+    size_t size() const { return m_entries.size(); }
+
+    /**
+     * Returns the number of disjoint sets.
+     *
+     * @return The number of sets.
+     */
+    size_t numSets() const { return m_numSets; }
+
+    /**
+     * Finds the representative of the set of an element.
+     *
+     * @param element The element. Elements out of range are in sets of their own.
+     * @return The representative of the set.
+     */
+    element_type find(element_type element) const;
+
+    /**
+     * Merges the sets of two elements, recording the merge.
+     *
+     * @param element1 The first element.
+     * @param element2 The second element.
+     * @return true, if a merge took place; false, if the elements were already in the same
+     *         set, or any of them is out of range.
+     */
+    bool join(element_type element1, element_type element2);
+
+    /**
+     * Tests whether two elements are in the same set.
+     *
+     * @param element1 The first element.
+     * @param element2 The second element.
+     * @return true, if the elements are in the same set; false, otherwise.
+     */
+    bool sameSet(element_type element1, element_type element2) const {
+        return find(element1) == find(element2);
+    }
+
+    /**
+     * Returns the size of the set of an element.
+     *
+     * @param element The element.
+     * @return The number of elements in the set.
+     */
+    size_t setSize(element_type element) const {
+        return contains(element) ? static_cast<size_t>(-m_entries[find(element)]) : 1;
+    }
+
+    /**
+     * Returns a checkpoint of the current state.
+     *
+     * @return The checkpoint.
+     */
+    Checkpoint checkpoint() const { return m_log.size(); }
+
+    /**
+     * Undoes all the merges done since a checkpoint. Checkpoints taken after it are no longer
+     * valid.
+     *
+     * @param checkpoint A checkpoint taken before. A checkpoint from the future is ignored.
+     */
+    void rollback(Checkpoint checkpoint);
+
+    /**
+     * Returns the memory used by the disjoint set, including its log.
+     *
+     * @return The number of bytes.
+     */
+    size_t memoryUsage() const {
+        return sizeof(*this) + m_entries.capacity() * sizeof(element_type) +
+               m_log.capacity() * sizeof(Merge);
+    }
+
+  private:
+    /// A root linked under another root, and the entry it had before
+    struct Merge {
+        element_type child;
+        element_type childEntry;
+    };
+
+    bool contains(element_type element) const {
+        return element >= 0 && static_cast<size_t>(element) < m_entries.size();
+    }
+
+    std::vector<element_type> m_entries; /// Parent of every element, or minus its set size
+    std::vector<Merge> m_log;
+    size_t m_numSets;
+};
+
+template <typename TElement>
+TElement RollbackDisjointSet<TElement>::find(element_type element) const {
+    if (!contains(element))
+        return element;
+
+    while (m_entries[element] >= 0)
+        element = m_entries[element];
+
+    return element;
+}
+
+template <typename TElement>
+bool RollbackDisjointSet<TElement>::join(element_type element1, element_type element2) {
+    if (!contains(element1) || !contains(element2))
+        return false;
+
+    element_type root1 = find(element1);
+    element_type root2 = find(element2);
+
+    if (root1 == root2)
+        return false;
+
+    // Sizes are negative, so the larger set has the smaller entry
+    if (m_entries[root1] > m_entries[root2])
+        std::swap(root1, root2);
+
+    m_log.push_back({root2, m_entries[root2]});
+    m_entries[root1] += m_entries[root2];
+    m_entries[root2] = root1;
+    --m_numSets;
+
+    return true;
+}
+
+template <typename TElement> void RollbackDisjointSet<TElement>::rollback(Checkpoint checkpoint) {
+    while (m_log.size() > checkpoint) {
+        const Merge &merge = m_log.back();
+        const element_type parent = m_entries[merge.child];
+
+        m_entries[parent] -= merge.childEntry;
+        m_entries[merge.child] = merge.childEntry;
+        ++m_numSets;
+        m_log.pop_back();
+    }
+}
+
+} // namespace cake
@@ -0,0 +1,95 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+namespace cake {
+
+/**
+ * Serializer of objects to binary streams, used by cache snapshots. Specializations are
+ * provided for fundamental types and strings; other types need a user-provided serializer
+ * with the same static interface:
+ *
+ *   static void write(std::ostream &output, const T &object);
+ *   static bool read(std::istream &input, T &object);
+ *
+ * where read returns false if the object could not be read.
+ */
+template <typename TObject, typename Enable = void> struct Serializer;
+
+/**
+ * Serializer of fundamental types. Objects are written as raw bytes, so snapshots are only
+ * portable between hosts with the same endianness.
+ */
+template <typename TObject>
+struct Serializer<TObject, std::enable_if_t<std::is_fundamental<TObject>::value>> {
+    static void write(std::ostream &output, const TObject &object) {
+        output.write(reinterpret_cast<const char *>(&object), sizeof(TObject));
+    }
+
+    static bool read(std::istream &input, TObject &object) {
+        return static_cast<bool>(input.read(reinterpret_cast<char *>(&object), sizeof(TObject)));
+    }
+};
+
+/**
+ * Serializer of strings. Strings are written as their length followed by their characters.
+ */
+template <typename TChar> struct Serializer<std::basic_string<TChar>> {
+    static void write(std::ostream &output, const std::basic_string<TChar> &str) {
+        Serializer<uint64_t>::write(output, str.size());
+        output.write(reinterpret_cast<const char *>(str.data()), str.size() * sizeof(TChar));
+    }
+
+    static bool read(std::istream &input, std::basic_string<TChar> &str) {
+        uint64_t size;
+
+        if (!Serializer<uint64_t>::read(input, size))
+            return false;
+
+        // Read in chunks, so that a corrupt size fails on the stream instead of on allocation
+        const uint64_t chunkSize = 4096;
+        str.clear();
+
+        while (str.size() < size) {
+            const size_t offset = str.size();
+            str.resize(offset + std::min(chunkSize, size - offset));
+
+            if (!input.read(reinterpret_cast<char *>(&str[offset]),
+                            (str.size() - offset) * sizeof(TChar)))
+                return false;
+        }
+
+        return true;
+    }
+};
+} // namespace cake
@@ -0,0 +1,115 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cake {
+
+/**
+ * Kernels with explicitly vectorized implementations, and the dispatch between them. The
+ * instruction sets of the CPU are detected once, the first time a kernel is called, and every
+ * kernel then runs the implementation for the best level the CPU supports. This way a single
+ * binary, built for the baseline instruction set, uses SIMD instructions wherever available.
+ * Only x86 has implementations beyond Level::Generic.
+ */
+namespace Simd {
+
+/**
+ * Levels of instruction sets, from least to most capable. Each level includes all the previous.
+ */
+enum class Level {
+    Generic, /// Portable C++
+    Sse42,   /// SSE4.2 and POPCNT
+    Avx2,    /// AVX2
+    Avx512   /// AVX-512 F, BW and DQ
+};
+
+/** Returns the best level supported by the CPU.
+ *
+ * @return The level.
+ */
+Level supportedLevel();
+
+/** Returns the level whose implementations the kernels run.
+ *
+ * @return The level.
+ */
+Level activeLevel();
+
+/**
+ * Makes the kernels run the implementations of a given level, e.g. to test or benchmark each
+ * of them. It must not be called while kernels are running in other threads.
+ *
+ * @param level Given level.
+ *
+ * @return true, when the CPU supports the level; false, when it does not, and the active level
+ * is left as it was.
+ */
+bool setLevel(Level level);
+
+/** Returns the name of a level.
+ *
+ * @param level Given level.
+ *
+ * @return A name such as "avx2".
+ */
+const char *levelName(Level level);
+
+/**
+ * Counts the bits set in an array of words.
+ *
+ * @param words Pointer to the words.
+ * @param numWords Number of words.
+ *
+ * @return The number of ones.
+ */
+uint64_t popcount(const uint64_t *words, size_t numWords);
+
+/**
+ * Merges an array of words into another one, with bitwise or.
+ *
+ * @param target Pointer to the words that get merged into.
+ * @param source Pointer to the words to merge, which may not overlap the target ones.
+ * @param numWords Number of words of each array.
+ */
+void bitwiseOr(uint64_t *target, const uint64_t *source, size_t numWords);
+
+/**
+ * Computes the 64bit MurmurHash2 of given data with several seeds, each hash being that of
+ * Hash::murmur64A.
+ *
+ * @param data Pointer to data.
+ * @param sizeInBytes Size in bytes of data.
+ * @param seeds Pointer to the seeds.
+ * @param hashes Pointer to where the hash for every seed is written.
+ * @param numSeeds Number of seeds.
+ */
+void murmur64A(const void *data, size_t sizeInBytes, const uint64_t *seeds, uint64_t *hashes,
+               size_t numSeeds);
+
+} // namespace Simd
+} // namespace cake
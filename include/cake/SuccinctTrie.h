@@ -0,0 +1,524 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cake/BitVector.h>
+#include <cake/MappedFile.h>
+#include <cake/PrefixTree.h>
+
+namespace cake {
+
+/**
+ * Immutable succinct trie. Stores a set of words as a LOUDS (level-order unary degree
+ * sequence) trie: the edges are numbered in breadth-first order, and the node an edge leads
+ * to takes the number of the edge plus one, the root being node 0. Besides one label per
+ * edge, it only needs three bit vectors with rank and select support:
+ *
+ *  - firstChild: one bit per edge, set if the edge is the first child of its parent.
+ *  - hasChildren: one bit per node, set if the node has children.
+ *  - isWordEnd: one bit per node, set if a word ends at the node.
+ *
+ * The children of the k-th node with children are the edges from the k-th set bit of
+ * firstChild up to the next one. For byte symbols this takes a little over 11 bits per edge.
+ *
+ * The whole trie is a single image of 64-bit words, which can be saved to a file and later
+ * memory-mapped and queried in place, without copying or parsing it. Images are written in
+ * the byte order of the machine, and are rejected by machines with a different one.
+ */
+template <typename TString> class SuccinctTrie {
+  public:
+    using string_type = TString;
+    using symbol_type = typename TString::value_type;
+
+    static constexpr uint64_t magic = 0x44554f4c454b4143; /// "CAKELOUD" in little-endian
+    static constexpr uint32_t version = 1;
+
+    /**
+     * Constructor. Creates an empty succinct trie.
+     */
+    SuccinctTrie();
+
+    /**
+     * Constructor. Creates a succinct trie with all the words in a given vector.
+     *
+     * @param words Container of words, in any order. Sorting is skipped if they are already
+     * sorted by code unit.
+     */
+    SuccinctTrie(std::vector<string_type> words);
+
+    /**
+     * Constructor. Creates a succinct trie with all the words in a prefix tree.
+     *
+     * @param tree Given prefix tree.
+     */
+    template <typename TAllocator, typename TScore>
+    explicit SuccinctTrie(const PrefixTree<TString, TAllocator, TScore> &tree);
+
+    SuccinctTrie(SuccinctTrie &&other) noexcept = default;
+    SuccinctTrie &operator=(SuccinctTrie &&other) noexcept = default;
+    SuccinctTrie(const SuccinctTrie &) = delete;
+    SuccinctTrie &operator=(const SuccinctTrie &) = delete;
+
+    /** Returns how many words the succinct trie contains.
+     *
+     * @return The number of words in the succinct trie.
+     */
+    size_t size() const { return m_numWords; }
+
+    /** Returns how many nodes the succinct trie has, including the root.
+     *
+     * @return The number of nodes in the succinct trie.
+     */
+    size_t numNodes() const { return m_numEdges + 1; }
+
+    /** Returns the size of the image of the succinct trie.
+     *
+     * @return The number of bytes of the image.
+     */
+    size_t sizeInBytes() const { return m_imageSize * sizeof(uint64_t); }
+
+    /**
+     * Returns the memory used by the succinct trie: the trie object and its image, when owned
+     * or mapped by the trie. A viewed image belongs to the caller and is not counted.
+     *
+     * @return The number of bytes.
+     */
+    size_t memoryUsage() const {
+        return sizeof(*this) + m_image.capacity() * sizeof(uint64_t) + m_file.size();
+    }
+
+    /**
+     * Checks if a word is in the succinct trie.
+     *
+     * @param word Given word.
+     *
+     * @return true if the word is present, otherwise false.
+     */
+    bool contains(const string_type &word) const;
+
+    /**
+     * Query succinct trie for all words that match a given prefix.
+     *
+     * @param prefix A given prefix.
+     *
+     * @return A vector with all the words that match the given prefix, in the same order as
+     * PrefixTree::query.
+     */
+    std::vector<string_type> query(const string_type &prefix) const;
+
+    /**
+     * Visit the words that match a given prefix in lexicographic order, as
+     * PrefixTree::forEach does.
+     *
+     * @param prefix A given prefix. An empty prefix matches every word.
+     * @param visitor Callable taking a const string_type &; returns false to stop the walk.
+     *
+     * @return false if the visitor stopped the walk, otherwise true.
+     */
+    template <typename TVisitor> bool forEach(const string_type &prefix, TVisitor &&visitor) const;
+
+    /**
+     * Writes the image of the succinct trie to a stream.
+     *
+     * @param output The stream.
+     *
+     * @return true if the image was written successfully.
+     */
+    bool save(std::ostream &output) const;
+
+    /**
+     * Replaces the contents of the succinct trie with an image read from a stream.
+     *
+     * @param input The stream.
+     *
+     * @return true if a valid image was read, otherwise false and the trie is unchanged.
+     */
+    bool load(std::istream &input);
+
+    /**
+     * Replaces the contents of the succinct trie with an image in memory, which is used in
+     * place. The memory must outlive the trie, or the next call that replaces its contents.
+     *
+     * @param data Pointer to the image, aligned to 8 bytes.
+     * @param size Size of the image in bytes.
+     *
+     * @return true if the image is valid, otherwise false and the trie is unchanged.
+     */
+    bool view(const void *data, size_t size);
+
+    /**
+     * Replaces the contents of the succinct trie with an image in a file, which is
+     * memory-mapped and used in place. Processes that map the same file share its pages.
+     *
+     * @param path Path of the file.
+     *
+     * @return true if the file holds a valid image, otherwise false and the trie is unchanged.
+     */
+    bool map(const std::string &path);
+
+  private:
+    using key_type = std::make_unsigned_t<symbol_type>;
+
+    static constexpr size_t headerSize = 4;
+    static constexpr size_t notFound = static_cast<size_t>(-1);
+
+    static size_t labelWords(size_t numEdges) {
+        return (numEdges * sizeof(symbol_type) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    }
+
+    /**
+     * Builds the image of a set of words, sorted by code unit and without duplicates.
+     */
+    static std::vector<uint64_t> buildImage(const std::vector<string_type> &words);
+
+    /**
+     * Makes the trie use an image, if it is valid.
+     */
+    bool attach(const uint64_t *data, size_t numWords);
+
+    /**
+     * Returns the range of edges that leave a node.
+     */
+    std::pair<size_t, size_t> children(size_t node) const;
+
+    /**
+     * Returns the node a word leads to, or notFound.
+     */
+    size_t findNode(const string_type &word) const;
+
+    template <typename TVisitor>
+    bool visit(size_t node, string_type &buffer, TVisitor &visitor) const;
+
+    std::vector<uint64_t> m_image; /// Image owned by the trie, if not viewed or mapped
+    MappedFile m_file;             /// Mapped image, if any
+    const uint64_t *m_imageData;
+    size_t m_imageSize; /// In 64-bit words
+    const symbol_type *m_labels;
+    size_t m_numWords;
+    size_t m_numEdges;
+    BitVector m_firstChild;
+    BitVector m_hasChildren;
+    BitVector m_isWordEnd;
+};
+
+template <typename TString>
+SuccinctTrie<TString>::SuccinctTrie() : SuccinctTrie(std::vector<string_type>()) {}
+
+template <typename TString>
+SuccinctTrie<TString>::SuccinctTrie(std::vector<string_type> words)
+    : m_imageData(nullptr), m_imageSize(0), m_labels(nullptr), m_numWords(0), m_numEdges(0) {
+    const auto less = PrefixTree<TString>::less;
+
+    if (!std::is_sorted(words.begin(), words.end(), less))
+        std::sort(words.begin(), words.end(), less);
+
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+
+    // The empty word can only be first
+    if (!words.empty() && words.front().empty())
+        words.erase(words.begin());
+
+    m_image = buildImage(words);
+    attach(m_image.data(), m_image.size());
+}
+
+template <typename TString>
+template <typename TAllocator, typename TScore>
+SuccinctTrie<TString>::SuccinctTrie(const PrefixTree<TString, TAllocator, TScore> &tree)
+    : SuccinctTrie([&tree]() {
+          std::vector<string_type> words;
+
+          words.reserve(tree.size());
+          tree.forEach(string_type(), [&words](const string_type &word) {
+              words.push_back(word);
+              return true;
+          });
+
+          return words;
+      }()) {}
+
+template <typename TString>
+std::vector<uint64_t> SuccinctTrie<TString>::buildImage(const std::vector<string_type> &words) {
+    // Nodes are ranges of words that share their first depth symbols
+    struct Range {
+        size_t begin;
+        size_t end;
+        size_t depth;
+    };
+
+    std::vector<Range> queue{{0, words.size(), 0}};
+    std::vector<symbol_type> labels;
+    std::vector<bool> firstChild;
+    std::vector<bool> hasChildren;
+    std::vector<bool> isWordEnd;
+
+    // Breadth-first, so the k-th node in the queue is node k
+    for (size_t node = 0; node < queue.size(); ++node) {
+        auto [begin, end, depth] = queue[node];
+        const bool wordEnd = begin < end && words[begin].size() == depth;
+
+        if (wordEnd)
+            ++begin;
+
+        isWordEnd.push_back(wordEnd);
+        hasChildren.push_back(begin < end);
+
+        for (size_t i = begin; i < end;) {
+            const symbol_type symbol = words[i][depth];
+            size_t j = i + 1;
+
+            while (j < end && words[j][depth] == symbol)
+                ++j;
+
+            labels.push_back(symbol);
+            firstChild.push_back(i == begin);
+            queue.push_back(Range{i, j, depth + 1});
+            i = j;
+        }
+    }
+
+    std::vector<uint64_t> image = {magic, version | uint64_t(sizeof(symbol_type)) << 32,
+                                   words.size(), labels.size()};
+
+    image.resize(headerSize + labelWords(labels.size()), 0);
+    std::memcpy(image.data() + headerSize, labels.data(), labels.size() * sizeof(symbol_type));
+
+    BitVector::appendImage(image, firstChild);
+    BitVector::appendImage(image, hasChildren);
+    BitVector::appendImage(image, isWordEnd);
+
+    return image;
+}
+
+template <typename TString>
+bool SuccinctTrie<TString>::attach(const uint64_t *data, size_t numWords) {
+    if (numWords < headerSize || data[0] != magic ||
+        data[1] != (version | uint64_t(sizeof(symbol_type)) << 32))
+        return false;
+
+    const size_t numEdges = data[3];
+
+    // Checked in steps, so that a corrupt size cannot overflow the total
+    if (numEdges / sizeof(uint64_t) >= numWords || labelWords(numEdges) > numWords - headerSize)
+        return false;
+
+    size_t position = headerSize + labelWords(numEdges);
+    BitVector bitVectors[3];
+
+    for (auto &bitVector : bitVectors) {
+        const size_t taken = bitVector.view(data + position, numWords - position);
+
+        if (taken == 0)
+            return false;
+
+        position += taken;
+    }
+
+    const auto &[firstChild, hasChildren, isWordEnd] = bitVectors;
+
+    if (firstChild.size() != numEdges || hasChildren.size() != numEdges + 1 ||
+        isWordEnd.size() != numEdges + 1 || firstChild.numOnes() != hasChildren.numOnes() ||
+        isWordEnd.numOnes() != data[2])
+        return false;
+
+    // The children of a node must come after it, so that the image is a tree and walks end.
+    // Pairs the k-th node with children with the k-th first child.
+    for (size_t node = 0, edge = 0; node <= numEdges; ++node) {
+        if (!hasChildren[node])
+            continue;
+
+        while (edge < numEdges && !firstChild[edge])
+            ++edge;
+
+        if (edge == numEdges || edge < node)
+            return false;
+
+        ++edge;
+    }
+
+    m_imageData = data;
+    m_imageSize = position;
+    m_labels = reinterpret_cast<const symbol_type *>(data + headerSize);
+    m_numWords = data[2];
+    m_numEdges = numEdges;
+    m_firstChild = firstChild;
+    m_hasChildren = hasChildren;
+    m_isWordEnd = isWordEnd;
+
+    return true;
+}
+
+template <typename TString>
+std::pair<size_t, size_t> SuccinctTrie<TString>::children(size_t node) const {
+    if (!m_hasChildren[node])
+        return {0, 0};
+
+    const size_t rank = m_hasChildren.rank1(node);
+    const size_t begin = m_firstChild.select1(rank);
+    const size_t end =
+        rank + 1 < m_firstChild.numOnes() ? m_firstChild.select1(rank + 1) : m_numEdges;
+
+    return {begin, end};
+}
+
+template <typename TString>
+size_t SuccinctTrie<TString>::findNode(const string_type &word) const {
+    size_t node = 0;
+
+    for (const symbol_type symbol : word) {
+        const auto [begin, end] = children(node);
+        const auto key = static_cast<key_type>(symbol);
+        const symbol_type *edge =
+            std::lower_bound(m_labels + begin, m_labels + end, key,
+                             [](symbol_type label, key_type k) {
+                                 return static_cast<key_type>(label) < k;
+                             });
+
+        if (edge == m_labels + end || *edge != symbol)
+            return notFound;
+
+        node = edge - m_labels + 1;
+    }
+
+    return node;
+}
+
+template <typename TString>
+bool SuccinctTrie<TString>::contains(const string_type &word) const {
+    if (word.empty())
+        return false;
+
+    const size_t node = findNode(word);
+
+    return node != notFound && m_isWordEnd[node];
+}
+
+template <typename TString>
+std::vector<TString> SuccinctTrie<TString>::query(const string_type &prefix) const {
+    std::vector<string_type> result;
+
+    if (prefix.empty())
+        return result;
+
+    forEach(prefix, [&result](const string_type &word) {
+        result.push_back(word);
+        return true;
+    });
+
+    return result;
+}
+
+template <typename TString>
+template <typename TVisitor>
+bool SuccinctTrie<TString>::forEach(const string_type &prefix, TVisitor &&visitor) const {
+    const size_t node = findNode(prefix);
+
+    if (node == notFound)
+        return true;
+
+    string_type buffer = prefix;
+
+    return visit(node, buffer, visitor);
+}
+
+template <typename TString>
+template <typename TVisitor>
+bool SuccinctTrie<TString>::visit(size_t node, string_type &buffer, TVisitor &visitor) const {
+    if (m_isWordEnd[node] && !visitor(static_cast<const string_type &>(buffer)))
+        return false;
+
+    const auto [begin, end] = children(node);
+
+    for (size_t edge = begin; edge < end; ++edge) {
+        buffer.push_back(m_labels[edge]);
+
+        if (!visit(edge + 1, buffer, visitor))
+            return false;
+
+        buffer.pop_back();
+    }
+
+    return true;
+}
+
+template <typename TString> bool SuccinctTrie<TString>::save(std::ostream &output) const {
+    output.write(reinterpret_cast<const char *>(m_imageData), sizeInBytes());
+
+    return static_cast<bool>(output.flush());
+}
+
+template <typename TString> bool SuccinctTrie<TString>::load(std::istream &input) {
+    const std::string bytes{std::istreambuf_iterator<char>(input),
+                            std::istreambuf_iterator<char>()};
+    std::vector<uint64_t> image(bytes.size() / sizeof(uint64_t));
+
+    std::memcpy(image.data(), bytes.data(), image.size() * sizeof(uint64_t));
+
+    if (!attach(image.data(), image.size()))
+        return false;
+
+    m_image = std::move(image);
+    m_file.close();
+
+    return true;
+}
+
+template <typename TString> bool SuccinctTrie<TString>::view(const void *data, size_t size) {
+    if (reinterpret_cast<uintptr_t>(data) % alignof(uint64_t) != 0 ||
+        !attach(static_cast<const uint64_t *>(data), size / sizeof(uint64_t)))
+        return false;
+
+    m_image = std::vector<uint64_t>();
+    m_file.close();
+
+    return true;
+}
+
+template <typename TString> bool SuccinctTrie<TString>::map(const std::string &path) {
+    MappedFile file;
+
+    if (!file.open(path) ||
+        !attach(static_cast<const uint64_t *>(file.data()), file.size() / sizeof(uint64_t)))
+        return false;
+
+    m_image = std::vector<uint64_t>();
+    m_file = std::move(file);
+
+    return true;
+}
+
+} // namespace cake
@@ -0,0 +1,272 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <list>
+
+#include <cake/MemoryUsage.h>
+
+namespace cake {
+
+/**
+ * Hierarchical Timer Wheel. Keeps a set of timers, each one holding a value and a deadline
+ * expressed in ticks, and fires them as time advances. Scheduling and cancelling timers are
+ * O(1), and advancing time is O(1) amortized per timer.
+ *
+ * The wheel has several levels of 64 slots each. A slot of level i spans 64^i ticks; timers
+ * far in the future live in coarse slots, and are cascaded to finer levels as their deadline
+ * approaches. Deadlines beyond the range of the top level are parked there and cascaded
+ * repeatedly until they are in range.
+ */
+template <typename TValue> class TimerWheel {
+  public:
+    using value_type = TValue;
+
+  private:
+    static constexpr size_t numLevels = 5;
+    static constexpr size_t slotBits = 6;
+    static constexpr size_t numSlots = static_cast<size_t>(1) << slotBits;
+    static constexpr size_t expiringLevel = numLevels; /// Level of timers being fired
+
+    struct Timer {
+        value_type value;
+        uint64_t deadline;
+        size_t level;
+        size_t slot;
+    };
+
+    using TimerList = std::list<Timer>;
+
+  public:
+    /**
+     * Handle to a scheduled timer. It is valid until the timer is fired or cancelled.
+     */
+    class Handle {
+      public:
+        Handle() = default;
+
+      private:
+        explicit Handle(typename TimerList::iterator it) : m_it(it) {}
+
+        typename TimerList::iterator m_it;
+
+        friend class TimerWheel<value_type>;
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param currentTick Tick the wheel starts at.
+     */
+    explicit TimerWheel(uint64_t currentTick = 0) : m_currentTick(currentTick), m_size(0) {
+        m_levelSizes.fill(0);
+    }
+
+    /**
+     * Returns the tick up to which the wheel has advanced.
+     */
+    uint64_t currentTick() const { return m_currentTick; }
+
+    /**
+     * Returns the number of timers scheduled.
+     */
+    size_t size() const { return m_size; }
+
+    /**
+     * Returns an estimate of the memory used by the wheel, including its empty slots.
+     *
+     * @return The number of bytes.
+     */
+    size_t memoryUsage() const { return sizeof(*this) + m_size * MemoryUsage::listNode<Timer>; }
+
+    /**
+     * Schedules a new timer. Deadlines that are not in the future are fired on the next tick.
+     *
+     * @param value Value held by the timer.
+     * @param deadline Tick at which the timer is fired.
+     *
+     * @return A handle to the timer.
+     */
+    Handle schedule(const value_type &value, uint64_t deadline);
+
+    /**
+     * Cancels a scheduled timer.
+     *
+     * @param handle Handle of the timer, which must not have been fired or cancelled yet.
+     */
+    void cancel(Handle handle);
+
+    /**
+     * Advances the wheel up to a given tick, firing all the timers with an earlier deadline.
+     * The callback may schedule and cancel other timers.
+     *
+     * @param tick The given tick. Ticks earlier than the current one are ignored.
+     * @param onExpired Callable invoked with the value of every fired timer.
+     */
+    template <typename TCallback> void advance(uint64_t tick, TCallback &&onExpired);
+
+  private:
+    /**
+     * Moves a timer into the slot that corresponds to its deadline.
+     *
+     * @param from List that currently owns the timer.
+     * @param it Iterator to the timer.
+     */
+    void place(TimerList &from, typename TimerList::iterator it);
+
+    /**
+     * Moves all the timers of a slot to the slots that correspond to their deadlines, now that
+     * time has advanced.
+     *
+     * @param level Level of the slot.
+     * @param slot Index of the slot.
+     */
+    void cascade(size_t level, size_t slot);
+
+    /**
+     * Returns the index of the slot of a given level that a given tick falls into.
+     */
+    static size_t slotIndex(uint64_t tick, size_t level) {
+        return (tick >> (slotBits * level)) & (numSlots - 1);
+    }
+
+  private:
+    std::array<std::array<TimerList, numSlots>, numLevels> m_slots;
+    std::array<size_t, numLevels> m_levelSizes;
+    TimerList m_expiring;
+    uint64_t m_currentTick;
+    size_t m_size;
+};
+
+template <typename TValue>
+typename TimerWheel<TValue>::Handle TimerWheel<TValue>::schedule(const value_type &value,
+                                                                 uint64_t deadline) {
+    m_expiring.push_back(Timer{value, std::max(deadline, m_currentTick + 1), expiringLevel, 0});
+
+    const auto it = std::prev(m_expiring.end());
+    place(m_expiring, it);
+    ++m_size;
+
+    return Handle(it);
+}
+
+template <typename TValue> void TimerWheel<TValue>::cancel(Handle handle) {
+    const auto it = handle.m_it;
+
+    if (it->level == expiringLevel) {
+        m_expiring.erase(it);
+    } else {
+        --m_levelSizes[it->level];
+        m_slots[it->level][it->slot].erase(it);
+    }
+
+    --m_size;
+}
+
+template <typename TValue>
+template <typename TCallback>
+void TimerWheel<TValue>::advance(uint64_t tick, TCallback &&onExpired) {
+    while (m_currentTick < tick) {
+        // Skip ahead over ticks that cannot fire or cascade anything: if levels 0..i are
+        // empty, nothing happens until the next boundary of level i + 1.
+        size_t emptyLevels = 0;
+        while (emptyLevels < numLevels && m_levelSizes[emptyLevels] == 0)
+            ++emptyLevels;
+
+        if (emptyLevels == numLevels) {
+            m_currentTick = tick;
+            break;
+        }
+
+        if (emptyLevels > 0) {
+            const uint64_t mask = (static_cast<uint64_t>(1) << (slotBits * emptyLevels)) - 1;
+            const uint64_t lastIdleTick = m_currentTick | mask;
+
+            if (lastIdleTick >= tick) {
+                m_currentTick = tick;
+                break;
+            }
+
+            m_currentTick = lastIdleTick;
+        }
+
+        ++m_currentTick;
+
+        for (size_t level = 1; level < numLevels; ++level) {
+            const uint64_t mask = (static_cast<uint64_t>(1) << (slotBits * level)) - 1;
+
+            if ((m_currentTick & mask) != 0)
+                break;
+
+            cascade(level, slotIndex(m_currentTick, level));
+        }
+
+        auto &slot = m_slots[0][slotIndex(m_currentTick, 0)];
+        m_levelSizes[0] -= slot.size();
+        m_expiring.splice(m_expiring.end(), slot);
+
+        for (auto &timer : m_expiring)
+            timer.level = expiringLevel;
+
+        while (!m_expiring.empty()) {
+            const value_type value = m_expiring.front().value;
+            m_expiring.pop_front();
+            --m_size;
+            onExpired(value);
+        }
+    }
+}
+
+template <typename TValue>
+void TimerWheel<TValue>::place(TimerList &from, typename TimerList::iterator it) {
+    const uint64_t maxDelta = (static_cast<uint64_t>(1) << (slotBits * numLevels)) - 1;
+    const uint64_t delta = it->deadline > m_currentTick ? it->deadline - m_currentTick : 0;
+    const uint64_t placedDeadline = m_currentTick + std::min(delta, maxDelta);
+
+    size_t level = 0;
+    while (level + 1 < numLevels && (delta >> (slotBits * (level + 1))) != 0)
+        ++level;
+
+    it->level = level;
+    it->slot = slotIndex(placedDeadline, level);
+    ++m_levelSizes[level];
+
+    auto &slot = m_slots[level][it->slot];
+    slot.splice(slot.end(), from, it);
+}
+
+template <typename TValue> void TimerWheel<TValue>::cascade(size_t level, size_t slot) {
+    auto &timers = m_slots[level][slot];
+    m_levelSizes[level] -= timers.size();
+
+    while (!timers.empty())
+        place(timers, timers.begin());
+}
+} // namespace cake
@@ -0,0 +1,341 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <list>
+#include <map>
+#include <utility>
+
+#include <cake/CountMinSketch.h>
+#include <cake/MemoryUsage.h>
+
+namespace cake {
+
+/**
+ * W-TinyLFU Cache data structure. Same interface as LRUCache, but the eviction policy
+ * is resistant to scans: a new entry first lands in a small LRU window, and when it
+ * leaves the window it is only admitted into the main area of the cache if it has been
+ * accessed more frequently than the entry it would evict. Frequencies are estimated by a
+ * Count-Min Sketch that is periodically aged, so it reflects recent history only.
+ *
+ * The main area is a segmented LRU: entries are admitted into a probation segment, and
+ * promoted to a protected segment when accessed again.
+ *
+ * Keys must be hashable by Hash::murmur64A (fundamental types or strings).
+ */
+template <class TKey, class TValue> class TinyLFUCache {
+  public:
+    using key_type = TKey;
+    using value_type = TValue;
+
+  private:
+    enum class Segment { Window, Probation, Protected };
+
+    struct Entry {
+        key_type key;
+        value_type value;
+        Segment segment;
+    };
+
+    using EntryList = std::list<Entry>;
+
+  public:
+    /**
+     * Constructor. A maximum size of zero is converted to one.
+     *
+     * @param maxSize Maximum size allowed.
+     */
+    explicit TinyLFUCache(size_t maxSize);
+
+    /**
+     * Returns the maximum number of entries allowed in the cache.
+     *
+     * @return Maximum size allowed.
+     */
+    size_t maxSize() const { return m_maxSize; }
+
+    /**
+     * Returns the number of entries currently in the cache.
+     *
+     * @return Current size.
+     */
+    size_t size() const { return m_cache.size(); }
+
+    /**
+     * Returns an estimate of the memory used by the cache: the cache object, the list node
+     * and the map node of every entry, and the frequency sketch. Memory owned by the keys and
+     * values themselves is not counted. It takes constant time.
+     *
+     * @return The number of bytes.
+     */
+    size_t memoryUsage() const {
+        using MapValue = typename decltype(m_cache)::value_type;
+
+        return sizeof(*this) - sizeof(m_sketch) + m_sketch.memoryUsage() +
+               m_cache.size() * (MemoryUsage::listNode<Entry> + MemoryUsage::treeNode<MapValue>);
+    }
+
+    /**
+     * Returns a reference to the entry with the given key. This operation counts as an
+     * access to the entry. If the entry does not exist, one is created.
+     *
+     * @param key The given key.
+     *
+     * @return A reference to the associated value.
+     */
+    value_type &operator[](const key_type &key);
+
+    /**
+     * Insert a new entry into the cache. This operation counts as an access to the entry.
+     * The new entry always enters the cache, but it may cause a less frequently used entry
+     * to be evicted, which is not necessarily the least recently used one.
+     *
+     * @param key The given key
+     * @param value The given value
+     */
+    void insert(const key_type &key, const value_type &value);
+
+    /**
+     * Checks if there is an entry with the given key. This operation counts as an access to
+     * the entry.
+     *
+     * @param key The given key
+     *
+     * @return true if there is an entry in the cache with the given key,
+     * false otherwise.
+     */
+    bool contains(const key_type &key);
+
+    /**
+     * Removes the entry with the given key.
+     *
+     * @param key The given key
+     *
+     * @return true if an entry was removed from the cache,
+     * false otherwise.
+     */
+    bool remove(const key_type &key);
+
+  private:
+    /**
+     * Records an access to a given key in the frequency sketch, aging the sketch when the
+     * sample period is over.
+     *
+     * @param key The given key.
+     */
+    void recordAccess(const key_type &key);
+
+    /**
+     * Updates the cache after a hit on the entry to which a given iterator points.
+     *
+     * @param it A given iterator.
+     */
+    void touchEntry(typename EntryList::iterator it);
+
+    /**
+     * Moves the least recently used entries out of the window while it is over capacity,
+     * deciding for each one whether it is admitted to the main area.
+     */
+    void evictFromWindow();
+
+    /**
+     * Demotes the least recently used protected entries to probation while the protected
+     * segment is over capacity.
+     */
+    void demoteFromProtected();
+
+    /**
+     * Evicts the entry to which a given iterator points.
+     *
+     * @param list The list that owns the entry.
+     * @param it A given iterator.
+     */
+    void evictEntry(EntryList &list, typename EntryList::iterator it);
+
+  private:
+    std::map<key_type, typename EntryList::iterator> m_cache;
+    EntryList m_window;
+    EntryList m_probation;
+    EntryList m_protected;
+    CountMinSketch m_sketch;
+    size_t m_maxSize;
+    size_t m_maxWindowSize;
+    size_t m_maxProtectedSize;
+    size_t m_sampleSize; /// Number of accesses after which the sketch is aged
+    size_t m_numSampled; /// Number of accesses since the sketch was last aged
+};
+
+template <class TKey, class TValue>
+TinyLFUCache<TKey, TValue>::TinyLFUCache(size_t maxSize)
+    : m_sketch(maxSize), m_maxSize(std::max(static_cast<size_t>(1), maxSize)), m_numSampled(0) {
+    // Split as recommended by the W-TinyLFU paper: 1% window, and a main area with
+    // 80% of its entries in the protected segment.
+    m_maxWindowSize = std::max(static_cast<size_t>(1), m_maxSize / 100);
+    m_maxProtectedSize = (m_maxSize - m_maxWindowSize) * 8 / 10;
+    m_sampleSize = 10 * std::max(m_maxSize, m_sketch.width());
+}
+
+template <class TKey, class TValue>
+TValue &TinyLFUCache<TKey, TValue>::operator[](const key_type &key) {
+    const auto it = m_cache.find(key);
+
+    if (it != m_cache.end()) {
+        recordAccess(key);
+        touchEntry(it->second);
+        return it->second->value;
+    }
+
+    insert(key, value_type());
+
+    return m_window.front().value;
+}
+
+template <class TKey, class TValue>
+void TinyLFUCache<TKey, TValue>::insert(const key_type &key, const value_type &value) {
+    recordAccess(key);
+
+    const auto it = m_cache.find(key);
+
+    if (it != m_cache.end()) {
+        it->second->value = value;
+        touchEntry(it->second);
+        return;
+    }
+
+    m_window.push_front(Entry{key, value, Segment::Window});
+    m_cache.emplace(key, m_window.begin());
+
+    evictFromWindow();
+}
+
+template <class TKey, class TValue> bool TinyLFUCache<TKey, TValue>::contains(const key_type &key) {
+    const auto it = m_cache.find(key);
+
+    if (it == m_cache.end())
+        return false;
+
+    recordAccess(key);
+    touchEntry(it->second);
+
+    return true;
+}
+
+template <class TKey, class TValue> bool TinyLFUCache<TKey, TValue>::remove(const key_type &key) {
+    const auto it = m_cache.find(key);
+
+    if (it == m_cache.end())
+        return false;
+
+    const auto entryIt = it->second;
+    m_cache.erase(it);
+
+    switch (entryIt->segment) {
+    case Segment::Window:
+        m_window.erase(entryIt);
+        break;
+    case Segment::Probation:
+        m_probation.erase(entryIt);
+        break;
+    case Segment::Protected:
+        m_protected.erase(entryIt);
+        break;
+    }
+
+    return true;
+}
+
+template <class TKey, class TValue>
+void TinyLFUCache<TKey, TValue>::recordAccess(const key_type &key) {
+    m_sketch.increment(key);
+
+    if (++m_numSampled == m_sampleSize) {
+        m_sketch.halve();
+        m_numSampled /= 2;
+    }
+}
+
+template <class TKey, class TValue>
+void TinyLFUCache<TKey, TValue>::touchEntry(typename EntryList::iterator it) {
+    switch (it->segment) {
+    case Segment::Window:
+        m_window.splice(m_window.begin(), m_window, it);
+        break;
+    case Segment::Probation:
+        it->segment = Segment::Protected;
+        m_protected.splice(m_protected.begin(), m_probation, it);
+        demoteFromProtected();
+        break;
+    case Segment::Protected:
+        m_protected.splice(m_protected.begin(), m_protected, it);
+        break;
+    }
+}
+
+template <class TKey, class TValue> void TinyLFUCache<TKey, TValue>::evictFromWindow() {
+    while (m_window.size() > m_maxWindowSize) {
+        const auto candidate = std::prev(m_window.end());
+
+        if (m_probation.size() + m_protected.size() + m_maxWindowSize < m_maxSize) {
+            candidate->segment = Segment::Probation;
+            m_probation.splice(m_probation.begin(), m_window, candidate);
+            continue;
+        }
+
+        EntryList &victimList = m_probation.empty() ? m_protected : m_probation;
+
+        if (victimList.empty()) {
+            evictEntry(m_window, candidate);
+            continue;
+        }
+
+        const auto victim = std::prev(victimList.end());
+
+        if (m_sketch.count(candidate->key) > m_sketch.count(victim->key)) {
+            evictEntry(victimList, victim);
+            candidate->segment = Segment::Probation;
+            m_probation.splice(m_probation.begin(), m_window, candidate);
+        } else {
+            evictEntry(m_window, candidate);
+        }
+    }
+}
+
+template <class TKey, class TValue> void TinyLFUCache<TKey, TValue>::demoteFromProtected() {
+    while (m_protected.size() > m_maxProtectedSize) {
+        const auto it = std::prev(m_protected.end());
+        it->segment = Segment::Probation;
+        m_probation.splice(m_probation.begin(), m_protected, it);
+    }
+}
+
+template <class TKey, class TValue>
+void TinyLFUCache<TKey, TValue>::evictEntry(EntryList &list, typename EntryList::iterator it) {
+    m_cache.erase(it->key);
+    list.erase(it);
+}
+} // namespace cake
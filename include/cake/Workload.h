@@ -0,0 +1,249 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <cake/AccessTrace.h>
+
+namespace cake {
+
+/**
+ * Generator of keys in [0, numKeys) with a Zipfian distribution, where the key of rank r
+ * (key r - 1) has a probability proportional to 1 / r^skew. Keys are drawn in constant time
+ * with the method of Gray et al. ("Quickly generating billion-record synthetic databases"),
+ * as in YCSB, after computing the normalization constant in time proportional to numKeys.
+ */
+class ZipfianGenerator {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param numKeys Number of distinct keys. A value of 0 is converted to 1.
+     * @param skew Skew of the distribution, where 0 is uniform. Values are clamped to the
+     * interval [0, 0.999], the range of the method.
+     * @param seed Seed of the random numbers.
+     */
+    explicit ZipfianGenerator(uint64_t numKeys, double skew = 0.99, uint64_t seed = 0);
+
+    /**
+     * Returns the number of distinct keys.
+     */
+    uint64_t numKeys() const { return m_numKeys; }
+
+    /**
+     * Draws the next key. The most popular key is 0.
+     *
+     * @return A key in [0, numKeys).
+     */
+    uint64_t next();
+
+  private:
+    std::mt19937_64 m_generator;
+    std::uniform_real_distribution<double> m_uniform;
+    uint64_t m_numKeys;
+    double m_skew;
+    double m_zeta;          /// Sum of 1 / r^skew over all the ranks
+    double m_alpha;         /// 1 / (1 - skew)
+    double m_eta;           /// Correction of the approximation of the tail
+    double m_secondCutoff;  /// 1 + 1 / 2^skew, where the keys past the two first begin
+};
+
+/**
+ * Generator of Zipfian keys whose popularity is scattered over the key space, so that the
+ * popular keys are not next to each other. The ranks of a ZipfianGenerator are hashed into
+ * [0, numKeys), so a few keys may share the popularity of more than one rank.
+ */
+class ScrambledZipfianGenerator {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param numKeys Number of distinct keys. A value of 0 is converted to 1.
+     * @param skew Skew of the distribution, as in ZipfianGenerator.
+     * @param seed Seed of the random numbers and of the scrambling.
+     */
+    explicit ScrambledZipfianGenerator(uint64_t numKeys, double skew = 0.99, uint64_t seed = 0)
+        : m_zipfian(numKeys, skew, seed), m_seed(seed) {}
+
+    /**
+     * Returns the number of distinct keys.
+     */
+    uint64_t numKeys() const { return m_zipfian.numKeys(); }
+
+    /**
+     * Draws the next key.
+     *
+     * @return A key in [0, numKeys).
+     */
+    uint64_t next();
+
+  private:
+    ZipfianGenerator m_zipfian;
+    uint64_t m_seed;
+};
+
+/**
+ * Generator of keys with temporal locality. Accesses go to a working set of keys, with a
+ * scrambled Zipfian popularity within it, and every phase the working set slides forward by
+ * a given number of keys, so that old keys go cold and new ones become hot.
+ */
+class TemporalLocalityGenerator {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param workingSetSize Number of keys of the working set. A value of 0 is converted to 1.
+     * @param phaseLength Number of accesses of every phase. A value of 0 is converted to 1.
+     * @param shift Number of keys the working set slides by between phases.
+     * @param skew Skew of the popularity within the working set, as in ZipfianGenerator.
+     * @param seed Seed of the random numbers.
+     */
+    TemporalLocalityGenerator(uint64_t workingSetSize, size_t phaseLength, uint64_t shift,
+                              double skew = 0.99, uint64_t seed = 0);
+
+    /**
+     * Draws the next key.
+     *
+     * @return A key in the current working set.
+     */
+    uint64_t next();
+
+  private:
+    ScrambledZipfianGenerator m_offsets;
+    size_t m_phaseLength;
+    uint64_t m_shift;
+    size_t m_numAccesses; /// Accesses so far in the current phase
+    uint64_t m_base;      /// First key of the current working set
+};
+
+/**
+ * Corpora of strings shaped like real-world keys, for benchmarks and tests. They are
+ * generated deterministically from a seed.
+ */
+namespace Corpus {
+
+/**
+ * Generates words made of syllables, with English-like lengths. Word frequencies follow a
+ * Zipfian distribution over a vocabulary of distinct words, so the words repeat and share
+ * many prefixes.
+ *
+ * @param numWords Number of words.
+ * @param seed Seed of the random numbers.
+ */
+std::vector<std::string> words(size_t numWords, uint64_t seed = 0);
+
+/**
+ * Generates URLs with a scheme, a host and a path, such as
+ * "https://www.mipalo.com/ka/tenu?id=42". Hosts follow a Zipfian distribution, so many
+ * URLs share long prefixes, as in a crawl.
+ *
+ * @param numUrls Number of URLs.
+ * @param seed Seed of the random numbers.
+ */
+std::vector<std::string> urls(size_t numUrls, uint64_t seed = 0);
+
+/**
+ * Generates random (version 4) UUIDs in their canonical form, such as
+ * "0e9ae8b6-4c3f-4d2b-9a47-2f3c81a8b6d0". They share no structure beyond their format.
+ *
+ * @param numUuids Number of UUIDs.
+ * @param seed Seed of the random numbers.
+ */
+std::vector<std::string> uuids(size_t numUuids, uint64_t seed = 0);
+
+} // namespace Corpus
+
+/**
+ * Writes the keys of a generator as an access trace, in the format of AccessTraceWriter.
+ *
+ * @param generator Generator with a next() method returning uint64_t keys.
+ * @param numAccesses Number of keys to write.
+ * @param writer Writer of the trace.
+ */
+template <typename TGenerator>
+void writeTrace(TGenerator &generator, size_t numAccesses, AccessTraceWriter &writer) {
+    for (size_t i = 0; i < numAccesses; ++i)
+        writer.write(generator.next());
+}
+
+/**
+ * Replays an access trace, calling a function with every key.
+ *
+ * @param trace Reader of the trace.
+ * @param function Callable taking a uint64_t key.
+ *
+ * @return The number of keys replayed.
+ */
+template <typename TFunction> size_t replayTrace(AccessTraceReader &trace, TFunction &&function) {
+    size_t numAccesses = 0;
+    uint64_t key;
+
+    while (trace.next(key)) {
+        function(key);
+        ++numAccesses;
+    }
+
+    return numAccesses;
+}
+
+/// Outcome of replaying a trace against a cache
+struct ReplayResult {
+    size_t numAccesses = 0;
+    size_t numHits = 0;
+
+    double hitRatio() const {
+        return numAccesses == 0 ? 0.0 : static_cast<double>(numHits) / numAccesses;
+    }
+};
+
+/**
+ * Replays an access trace against a cache, as a cache in front of a backend would see it:
+ * every key is looked up, and inserted if missing.
+ *
+ * @param trace Reader of the trace.
+ * @param cache Cache with uint64_t keys, such as LRUCache or TinyLFUCache. Missing keys are
+ * inserted with a value-initialized value.
+ *
+ * @return The number of accesses and hits.
+ */
+template <typename TCache> ReplayResult replayCache(AccessTraceReader &trace, TCache &cache) {
+    ReplayResult result;
+
+    result.numAccesses = replayTrace(trace, [&](uint64_t key) {
+        if (cache.contains(key))
+            ++result.numHits;
+        else
+            cache.insert(key, typename TCache::value_type());
+    });
+
+    return result;
+}
+
+} // namespace cake
@@ -0,0 +1,82 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cake/AccessTrace.h>
+
+#include <algorithm>
+
+namespace cake {
+
+namespace {
+uint64_t fromLittleEndian(uint64_t value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return __builtin_bswap64(value);
+#else
+    return value;
+#endif
+}
+} // namespace
+
+AccessTraceReader::AccessTraceReader(std::istream &input, size_t bufferSize)
+    : m_input(input), m_buffer(std::max(static_cast<size_t>(1), bufferSize)), m_position(0),
+      m_size(0) {}
+
+bool AccessTraceReader::next(uint64_t &key) {
+    if (m_position == m_size && !refill())
+        return false;
+
+    key = fromLittleEndian(m_buffer[m_position++]);
+
+    return true;
+}
+
+bool AccessTraceReader::refill() {
+    m_input.read(reinterpret_cast<char *>(m_buffer.data()), m_buffer.size() * sizeof(uint64_t));
+
+    // A truncated key at the end of the trace is ignored
+    m_size = static_cast<size_t>(m_input.gcount()) / sizeof(uint64_t);
+    m_position = 0;
+
+    return m_size > 0;
+}
+
+AccessTraceWriter::AccessTraceWriter(std::ostream &output, size_t bufferSize) : m_output(output) {
+    m_buffer.reserve(std::max(static_cast<size_t>(1), bufferSize));
+}
+
+AccessTraceWriter::~AccessTraceWriter() { flush(); }
+
+void AccessTraceWriter::write(uint64_t key) {
+    m_buffer.push_back(fromLittleEndian(key));
+
+    if (m_buffer.size() == m_buffer.capacity())
+        flush();
+}
+
+void AccessTraceWriter::flush() {
+    m_output.write(reinterpret_cast<const char *>(m_buffer.data()),
+                   m_buffer.size() * sizeof(uint64_t));
+    m_buffer.clear();
+}
+} // namespace cake
@@ -0,0 +1,149 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cake/BitVector.h>
+
+#include <algorithm>
+
+#include <cake/Simd.h>
+
+namespace cake {
+
+namespace {
+size_t divideRoundingUp(size_t dividend, size_t divisor) {
+    return (dividend + divisor - 1) / divisor;
+}
+} // namespace
+
+BitVector::BitVector() : m_words(nullptr), m_ranks(nullptr), m_numBits(0), m_numBlocks(0) {}
+
+void BitVector::appendImage(std::vector<uint64_t> &image, const std::vector<bool> &bits) {
+    const size_t numWords = divideRoundingUp(bits.size(), 64);
+    const size_t numBlocks = divideRoundingUp(numWords, wordsPerBlock);
+    const size_t wordsStart = image.size() + 1;
+
+    image.push_back(bits.size());
+    image.resize(wordsStart + numWords, 0);
+
+    for (size_t i = 0; i < bits.size(); ++i) {
+        if (bits[i])
+            image[wordsStart + i / 64] |= uint64_t(1) << (i % 64);
+    }
+
+    uint64_t ones = 0;
+
+    for (size_t block = 0; block < numBlocks; ++block) {
+        image.push_back(ones);
+
+        const size_t first = block * wordsPerBlock;
+        const size_t end = std::min(numWords, first + wordsPerBlock);
+
+        ones += Simd::popcount(image.data() + wordsStart + first, end - first);
+    }
+
+    image.push_back(ones);
+}
+
+size_t BitVector::view(const uint64_t *data, size_t numWords) {
+    if (numWords == 0)
+        return 0;
+
+    const size_t numBits = data[0];
+    const size_t numBitWords = numBits / 64 + (numBits % 64 != 0);
+    const size_t numBlocks = divideRoundingUp(numBitWords, wordsPerBlock);
+
+    // Checked in steps, so that a corrupt size cannot overflow the total
+    if (numBitWords >= numWords || numBlocks + 1 > numWords - 1 - numBitWords)
+        return 0;
+
+    const uint64_t *words = data + 1;
+    const uint64_t *ranks = words + numBitWords;
+
+    // No bits may be set past the end
+    if (numBits % 64 != 0 && (words[numBitWords - 1] >> (numBits % 64)) != 0)
+        return 0;
+
+    // The stored ranks must be those of the bits, as rank1 and select1 rely on them
+    uint64_t ones = 0;
+
+    for (size_t block = 0; block < numBlocks; ++block) {
+        if (ranks[block] != ones)
+            return 0;
+
+        const size_t first = block * wordsPerBlock;
+        const size_t end = std::min(numBitWords, first + wordsPerBlock);
+
+        ones += Simd::popcount(words + first, end - first);
+    }
+
+    if (ranks[numBlocks] != ones)
+        return 0;
+
+    m_numBits = numBits;
+    m_numBlocks = numBlocks;
+    m_words = data + 1;
+    m_ranks = m_words + numBitWords;
+
+    return 1 + numBitWords + numBlocks + 1;
+}
+
+size_t BitVector::rank1(size_t position) const {
+    const size_t block = position / 64 / wordsPerBlock;
+    size_t rank = m_ranks[block];
+
+    for (size_t word = block * wordsPerBlock; word < position / 64; ++word)
+        rank += __builtin_popcountll(m_words[word]);
+
+    if (position % 64 != 0) {
+        const uint64_t mask = (uint64_t(1) << (position % 64)) - 1;
+
+        rank += __builtin_popcountll(m_words[position / 64] & mask);
+    }
+
+    return rank;
+}
+
+size_t BitVector::select1(size_t rank) const {
+    // Last block with fewer ones before it than the rank
+    const size_t block =
+        std::upper_bound(m_ranks, m_ranks + m_numBlocks, static_cast<uint64_t>(rank)) - m_ranks -
+        1;
+    size_t remaining = rank - m_ranks[block];
+
+    for (size_t word = block * wordsPerBlock;; ++word) {
+        uint64_t bits = m_words[word];
+        const size_t ones = __builtin_popcountll(bits);
+
+        if (remaining < ones) {
+            for (; remaining > 0; --remaining)
+                bits &= bits - 1;
+
+            return word * 64 + __builtin_ctzll(bits);
+        }
+
+        remaining -= ones;
+    }
+}
+
+} // namespace cake
@@ -27,11 +27,12 @@
 #include <algorithm>
 #include <cmath>
 
+#include <cake/Simd.h>
+
 namespace cake {
 
 namespace {
 const size_t maxNumBits = (static_cast<size_t>(1) << 35); // Around 4GB
-const size_t maxNumHashes = 256;
 } // namespace
 
 BloomFilter::BloomFilter(size_t expectedNumElements, double falsePositiveRate = 0.01)
@@ -46,21 +47,25 @@ BloomFilter::BloomFilter(size_t expectedNumElements, double falsePositiveRate =
     const size_t numHashes = (numBits / m_expectedNumElements) * ln_2;
 
     m_numHashes = std::min(numHashes, maxNumHashes);
-    m_bitArray = std::vector<bool>(std::min(numBits, maxNumBits), false);
-}
+    m_numBits = std::min(numBits, maxNumBits);
+    m_words = std::vector<uint64_t>((m_numBits + 63) / 64, 0);
 
-void BloomFilter::clear() {
-    for (size_t i = 0; i < m_bitArray.size(); i++)
-        m_bitArray[i] = false;
+    for (size_t i = 1; i <= m_numHashes; ++i)
+        m_seeds.push_back(m_numBits * i);
 }
 
-double BloomFilter::occupancy() const {
-    double occupancy = 0.0;
+void BloomFilter::clear() { std::fill(m_words.begin(), m_words.end(), 0); }
+
+bool BloomFilter::merge(const BloomFilter &other) {
+    if (m_numBits != other.m_numBits || m_numHashes != other.m_numHashes)
+        return false;
 
-    for (const auto bit : m_bitArray) {
-        occupancy += bit ? 1.0 : 0.0;
-    }
+    Simd::bitwiseOr(m_words.data(), other.m_words.data(), m_words.size());
 
-    return occupancy / m_bitArray.size();
+    return true;
+}
+
+double BloomFilter::occupancy() const {
+    return static_cast<double>(Simd::popcount(m_words.data(), m_words.size())) / m_numBits;
 }
 } // namespace cake
\ No newline at end of file
@@ -0,0 +1,48 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cake/CountMinSketch.h>
+
+#include <algorithm>
+
+namespace cake {
+
+namespace {
+const size_t minWidth = 16;
+} // namespace
+
+CountMinSketch::CountMinSketch(size_t expectedNumElements) : m_width(minWidth) {
+    while (m_width < expectedNumElements)
+        m_width <<= 1;
+
+    m_counts = std::vector<counter_type>(numRows * m_width, 0);
+}
+
+void CountMinSketch::halve() {
+    for (auto &count : m_counts)
+        count >>= 1;
+}
+
+void CountMinSketch::clear() { std::fill(m_counts.begin(), m_counts.end(), 0); }
+} // namespace cake
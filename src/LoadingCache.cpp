@@ -22,14 +22,10 @@
  * SOFTWARE.
  */
 
-#include <cake/Hash.h>
+#include <cake/LoadingCache.h>
 
-#include "MurmurHash2.h"
+#include <string>
 
 namespace cake {
-namespace Hash {
-uint64_t murmur64A(const void *data, size_t sizeInBytes, uint64_t seed) {
-    return MurmurHash64A(data, static_cast<int>(sizeInBytes), seed);
-};
-} // namespace Hash
-} // namespace cake
\ No newline at end of file
+template class LoadingCache<int, std::string>;
+} // namespace cake
@@ -0,0 +1,238 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cake/MissRatioCurve.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include <cake/Hash.h>
+#include <cake/LRUCache.h>
+#include <cake/TinyLFUCache.h>
+
+namespace cake {
+
+namespace {
+const uint64_t samplingModulus = static_cast<uint64_t>(1) << 24;
+const size_t minFenwickSize = 1024;
+} // namespace
+
+MissRatioCurve::MissRatioCurve(double samplingRate)
+    : m_samplingRate(std::clamp(samplingRate, 0.0001, 1.0)), m_numAccesses(0), m_numSampled(0),
+      m_numColdMisses(0), m_fenwick(minFenwickSize + 1, 0), m_time(0) {
+    m_samplingThreshold = static_cast<uint64_t>(m_samplingRate * samplingModulus);
+}
+
+void MissRatioCurve::access(uint64_t key) {
+    ++m_numAccesses;
+
+    if (m_samplingThreshold < samplingModulus &&
+        Hash::murmur64A(key, 0) % samplingModulus >= m_samplingThreshold)
+        return;
+
+    ++m_numSampled;
+
+    if (m_time + 1 == m_fenwick.size())
+        compact();
+
+    const auto it = m_lastAccess.find(key);
+
+    if (it == m_lastAccess.end()) {
+        ++m_numColdMisses;
+        m_lastAccess.emplace(key, m_time);
+    } else {
+        // Every key has exactly one mark, so the marks after the last access of this key
+        // are the distinct keys accessed since then.
+        const uint64_t distance = m_lastAccess.size() - countMarks(it->second);
+
+        if (distance >= m_distanceCounts.size())
+            m_distanceCounts.resize(distance + 1, 0);
+
+        ++m_distanceCounts[distance];
+        updateMark(it->second, -1);
+        it->second = m_time;
+    }
+
+    updateMark(m_time, 1);
+    ++m_time;
+}
+
+void MissRatioCurve::access(AccessTraceReader &trace) {
+    uint64_t key;
+
+    while (trace.next(key))
+        access(key);
+}
+
+double MissRatioCurve::missRatio(size_t cacheSize) const {
+    return missRatios({cacheSize}).front();
+}
+
+std::vector<double> MissRatioCurve::missRatios(const std::vector<size_t> &cacheSizes) const {
+    std::vector<uint64_t> cumulativeHits(m_distanceCounts.size() + 1, 0);
+
+    for (size_t d = 0; d < m_distanceCounts.size(); ++d)
+        cumulativeHits[d + 1] = cumulativeHits[d] + m_distanceCounts[d];
+
+    std::vector<double> ratios;
+
+    for (const size_t cacheSize : cacheSizes) {
+        if (m_numSampled == 0) {
+            ratios.push_back(0.0);
+            continue;
+        }
+
+        // A sampled distance d stands for a distance of d / samplingRate, which hits if it is
+        // smaller than the cache size.
+        const double scaledSize = cacheSize * m_samplingRate;
+        const size_t numHitDistances =
+            std::min(static_cast<size_t>(std::ceil(scaledSize)), m_distanceCounts.size());
+        const uint64_t hits = cumulativeHits[numHitDistances];
+
+        ratios.push_back(static_cast<double>(m_numSampled - hits) / m_numSampled);
+    }
+
+    return ratios;
+}
+
+std::vector<std::pair<size_t, double>> MissRatioCurve::curve() const {
+    std::vector<std::pair<size_t, double>> points;
+
+    if (m_numSampled == 0)
+        return points;
+
+    uint64_t hits = 0;
+    points.emplace_back(0, 1.0);
+
+    for (size_t d = 0; d < m_distanceCounts.size(); ++d) {
+        if (m_distanceCounts[d] == 0)
+            continue;
+
+        hits += m_distanceCounts[d];
+
+        const auto cacheSize = static_cast<size_t>(std::floor(d / m_samplingRate)) + 1;
+        const double ratio = static_cast<double>(m_numSampled - hits) / m_numSampled;
+
+        if (points.back().first == cacheSize)
+            points.back().second = ratio;
+        else
+            points.emplace_back(cacheSize, ratio);
+    }
+
+    return points;
+}
+
+void MissRatioCurve::updateMark(uint64_t time, int64_t delta) {
+    for (uint64_t i = time + 1; i < m_fenwick.size(); i += i & (~i + 1))
+        m_fenwick[i] += delta;
+}
+
+uint64_t MissRatioCurve::countMarks(uint64_t time) const {
+    uint64_t count = 0;
+
+    for (uint64_t i = time + 1; i > 0; i -= i & (~i + 1))
+        count += m_fenwick[i];
+
+    return count;
+}
+
+void MissRatioCurve::compact() {
+    std::vector<std::pair<uint64_t, uint64_t>> timesAndKeys;
+    timesAndKeys.reserve(m_lastAccess.size());
+
+    for (const auto &[key, time] : m_lastAccess)
+        timesAndKeys.emplace_back(time, key);
+
+    std::sort(timesAndKeys.begin(), timesAndKeys.end());
+
+    const size_t size = std::max(minFenwickSize, 2 * timesAndKeys.size());
+    m_fenwick.assign(size + 1, 0);
+
+    for (size_t i = 0; i < timesAndKeys.size(); ++i) {
+        m_lastAccess[timesAndKeys[i].second] = i;
+        m_fenwick[i + 1] = 1;
+    }
+
+    // Linear time construction: every node pushes its count to its parent
+    for (size_t i = 1; i < m_fenwick.size(); ++i) {
+        const size_t parent = i + (i & (~i + 1));
+
+        if (parent < m_fenwick.size())
+            m_fenwick[parent] += m_fenwick[i];
+    }
+
+    m_time = timesAndKeys.size();
+}
+
+std::vector<PolicyComparison> comparePolicies(AccessTraceReader &trace,
+                                              const std::vector<size_t> &cacheSizes,
+                                              double samplingRate) {
+    struct Replay {
+        explicit Replay(size_t cacheSize)
+            : lruCache(cacheSize), tinyLFUCache(cacheSize), lruMisses(0), tinyLFUMisses(0) {}
+
+        LRUCache<uint64_t, bool> lruCache;
+        TinyLFUCache<uint64_t, bool> tinyLFUCache;
+        uint64_t lruMisses;
+        uint64_t tinyLFUMisses;
+    };
+
+    std::vector<std::unique_ptr<Replay>> replays;
+    MissRatioCurve missRatioCurve(samplingRate);
+
+    for (const size_t cacheSize : cacheSizes)
+        replays.push_back(std::make_unique<Replay>(cacheSize));
+
+    uint64_t key;
+
+    while (trace.next(key)) {
+        missRatioCurve.access(key);
+
+        for (auto &replay : replays) {
+            if (!replay->lruCache.contains(key)) {
+                ++replay->lruMisses;
+                replay->lruCache.insert(key, true);
+            }
+
+            if (!replay->tinyLFUCache.contains(key)) {
+                ++replay->tinyLFUMisses;
+                replay->tinyLFUCache.insert(key, true);
+            }
+        }
+    }
+
+    const auto curveMissRatios = missRatioCurve.missRatios(cacheSizes);
+    const auto numAccesses =
+        static_cast<double>(std::max<uint64_t>(1, missRatioCurve.numAccesses()));
+    std::vector<PolicyComparison> comparisons;
+
+    for (size_t i = 0; i < cacheSizes.size(); ++i) {
+        comparisons.push_back({cacheSizes[i], replays[i]->lruMisses / numAccesses,
+                               replays[i]->tinyLFUMisses / numAccesses, curveMissRatios[i]});
+    }
+
+    return comparisons;
+}
+} // namespace cake
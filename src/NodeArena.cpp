@@ -0,0 +1,154 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cake/NodeArena.h>
+
+#include <utility>
+
+namespace cake {
+
+NodeArena::NodeArena()
+    : m_next(nullptr), m_end(nullptr), m_smallFreeLists(maxSmallSize / alignment + 1, nullptr),
+      m_bytesReserved(0) {}
+
+NodeArena::NodeArena(NodeArena &&other) noexcept
+    : m_chunks(std::move(other.m_chunks)), m_next(std::exchange(other.m_next, nullptr)),
+      m_end(std::exchange(other.m_end, nullptr)),
+      m_smallFreeLists(std::move(other.m_smallFreeLists)),
+      m_largeFreeLists(std::move(other.m_largeFreeLists)),
+      m_bytesReserved(std::exchange(other.m_bytesReserved, 0)) {
+    other.m_chunks.clear();
+    other.m_smallFreeLists.assign(maxSmallSize / alignment + 1, nullptr);
+    other.m_largeFreeLists.clear();
+}
+
+NodeArena &NodeArena::operator=(NodeArena &&other) noexcept {
+    if (this != &other) {
+        releaseChunks();
+        m_chunks = std::move(other.m_chunks);
+        m_next = std::exchange(other.m_next, nullptr);
+        m_end = std::exchange(other.m_end, nullptr);
+        m_smallFreeLists = std::move(other.m_smallFreeLists);
+        m_largeFreeLists = std::move(other.m_largeFreeLists);
+        m_bytesReserved = std::exchange(other.m_bytesReserved, 0);
+        other.m_chunks.clear();
+        other.m_smallFreeLists.assign(maxSmallSize / alignment + 1, nullptr);
+        other.m_largeFreeLists.clear();
+    }
+
+    return *this;
+}
+
+NodeArena::~NodeArena() { releaseChunks(); }
+
+void *NodeArena::allocate(size_t size) {
+    size = roundUp(size);
+
+    FreeBlock *&freeBlocks = freeList(size);
+
+    if (freeBlocks != nullptr) {
+        FreeBlock *block = freeBlocks;
+
+        freeBlocks = block->next;
+
+        return block;
+    }
+
+    if (static_cast<size_t>(m_end - m_next) < size) {
+        // Large nodes get a chunk of their own, so as not to waste the current one
+        if (size > chunkSize / 4) {
+            m_chunks.push_back(::operator new(size));
+            m_bytesReserved += size;
+
+            return m_chunks.back();
+        }
+
+        m_chunks.push_back(::operator new(chunkSize));
+        m_bytesReserved += chunkSize;
+        m_next = static_cast<char *>(m_chunks.back());
+        m_end = m_next + chunkSize;
+    }
+
+    void *pointer = m_next;
+
+    m_next += size;
+
+    return pointer;
+}
+
+void NodeArena::deallocate(void *pointer, size_t size) {
+    FreeBlock *&freeBlocks = freeList(roundUp(size));
+    auto *block = static_cast<FreeBlock *>(pointer);
+
+    block->next = freeBlocks;
+    freeBlocks = block;
+}
+
+void NodeArena::merge(NodeArena &other) {
+    m_chunks.insert(m_chunks.end(), other.m_chunks.begin(), other.m_chunks.end());
+    m_bytesReserved += other.m_bytesReserved;
+
+    // The rest of the current chunk of the other arena is lost
+    const auto append = [](FreeBlock *&list, FreeBlock *blocks) {
+        if (blocks == nullptr)
+            return;
+
+        FreeBlock *last = blocks;
+
+        while (last->next != nullptr)
+            last = last->next;
+
+        last->next = list;
+        list = blocks;
+    };
+
+    for (size_t i = 0; i < m_smallFreeLists.size(); ++i)
+        append(m_smallFreeLists[i], other.m_smallFreeLists[i]);
+
+    for (const auto &[size, blocks] : other.m_largeFreeLists)
+        append(m_largeFreeLists[size], blocks);
+
+    other.m_chunks.clear();
+    other.m_next = nullptr;
+    other.m_end = nullptr;
+    other.m_smallFreeLists.assign(maxSmallSize / alignment + 1, nullptr);
+    other.m_largeFreeLists.clear();
+    other.m_bytesReserved = 0;
+}
+
+NodeArena::FreeBlock *&NodeArena::freeList(size_t roundedSize) {
+    if (roundedSize <= maxSmallSize)
+        return m_smallFreeLists[roundedSize / alignment];
+
+    return m_largeFreeLists[roundedSize];
+}
+
+void NodeArena::releaseChunks() {
+    for (void *chunk : m_chunks)
+        ::operator delete(chunk);
+
+    m_chunks.clear();
+}
+
+} // namespace cake
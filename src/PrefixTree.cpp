@@ -32,5 +32,7 @@ template class PrefixTree<std::string>;
 template class PrefixTree<std::wstring>;
 template class PrefixTree<std::u16string>;
 template class PrefixTree<std::u32string>;
+template class PrefixTree<std::string, HeapNodeAllocator>;
+template class PrefixTree<std::string, NodeArena, double>;
 
 } // namespace cake
\ No newline at end of file
@@ -0,0 +1,327 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cake/Simd.h>
+
+#include <algorithm>
+#include <atomic>
+
+#include <cake/Hash.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CAKE_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace cake {
+namespace Simd {
+
+namespace {
+
+uint64_t popcountGeneric(const uint64_t *words, size_t numWords) {
+    uint64_t count = 0;
+
+    for (size_t i = 0; i < numWords; ++i)
+        count += __builtin_popcountll(words[i]);
+
+    return count;
+}
+
+void bitwiseOrGeneric(uint64_t *target, const uint64_t *source, size_t numWords) {
+    for (size_t i = 0; i < numWords; ++i)
+        target[i] |= source[i];
+}
+
+void murmur64AGeneric(const void *data, size_t sizeInBytes, const uint64_t *seeds,
+                      uint64_t *hashes, size_t numSeeds) {
+    for (size_t i = 0; i < numSeeds; ++i)
+        hashes[i] = Hash::murmur64A(data, sizeInBytes, seeds[i]);
+}
+
+#ifdef CAKE_SIMD_X86
+
+__attribute__((target("popcnt"))) uint64_t popcountSse42(const uint64_t *words,
+                                                         size_t numWords) {
+    // Independent sums, so that consecutive popcnt instructions do not wait for each other
+    uint64_t counts[4] = {0, 0, 0, 0};
+    size_t i = 0;
+
+    for (; i + 4 <= numWords; i += 4) {
+        counts[0] += __builtin_popcountll(words[i]);
+        counts[1] += __builtin_popcountll(words[i + 1]);
+        counts[2] += __builtin_popcountll(words[i + 2]);
+        counts[3] += __builtin_popcountll(words[i + 3]);
+    }
+
+    for (; i < numWords; ++i)
+        counts[0] += __builtin_popcountll(words[i]);
+
+    return counts[0] + counts[1] + counts[2] + counts[3];
+}
+
+/*
+ * The AVX2 and AVX-512 population counts look up the count of every 4 bits in a table of 16
+ * entries, with a byte shuffle, and add up the bytes of every 64-bit lane with a sum of
+ * absolute differences against zero.
+ */
+
+__attribute__((target("avx2,popcnt"))) uint64_t popcountAvx2(const uint64_t *words,
+                                                             size_t numWords) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0,
+                                            1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibbles = _mm256_set1_epi8(0x0f);
+    __m256i counts = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; i + 4 <= numWords; i += 4) {
+        const __m256i bits = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(words + i));
+        const __m256i low = _mm256_shuffle_epi8(lookup, _mm256_and_si256(bits, lowNibbles));
+        const __m256i high = _mm256_shuffle_epi8(
+            lookup, _mm256_and_si256(_mm256_srli_epi16(bits, 4), lowNibbles));
+
+        counts = _mm256_add_epi64(
+            counts, _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256()));
+    }
+
+    uint64_t lanes[4];
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), counts);
+
+    uint64_t count = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+
+    for (; i < numWords; ++i)
+        count += __builtin_popcountll(words[i]);
+
+    return count;
+}
+
+__attribute__((target("avx512f,avx512bw"))) uint64_t popcountAvx512(const uint64_t *words,
+                                                                    size_t numWords) {
+    // The table of popcountAvx2 as 64-bit words, in every 16 bytes
+    const __m512i lookup =
+        _mm512_set4_epi64(0x0403030203020201, 0x0302020102010100, 0x0403030203020201,
+                          0x0302020102010100);
+    const __m512i lowNibbles = _mm512_set1_epi8(0x0f);
+    __m512i counts = _mm512_setzero_si512();
+
+    for (size_t i = 0; i < numWords; i += 8) {
+        // The last words are loaded with a mask, and the words left out count as 0
+        const size_t numLoaded = std::min<size_t>(8, numWords - i);
+        const __mmask8 mask = static_cast<__mmask8>((1u << numLoaded) - 1);
+        const __m512i bits = _mm512_maskz_loadu_epi64(mask, words + i);
+        const __m512i low = _mm512_shuffle_epi8(lookup, _mm512_and_si512(bits, lowNibbles));
+        const __m512i high = _mm512_shuffle_epi8(
+            lookup, _mm512_and_si512(_mm512_srli_epi16(bits, 4), lowNibbles));
+
+        counts = _mm512_add_epi64(
+            counts, _mm512_sad_epu8(_mm512_add_epi8(low, high), _mm512_setzero_si512()));
+    }
+
+    uint64_t lanes[8];
+
+    _mm512_storeu_si512(lanes, counts);
+
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + lanes[4] + lanes[5] + lanes[6] + lanes[7];
+}
+
+__attribute__((target("avx2"))) void bitwiseOrAvx2(uint64_t *target, const uint64_t *source,
+                                                   size_t numWords) {
+    size_t i = 0;
+
+    for (; i + 4 <= numWords; i += 4) {
+        auto *targetWords = reinterpret_cast<__m256i *>(target + i);
+        const __m256i sourceWords =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + i));
+
+        _mm256_storeu_si256(targetWords,
+                            _mm256_or_si256(_mm256_loadu_si256(targetWords), sourceWords));
+    }
+
+    for (; i < numWords; ++i)
+        target[i] |= source[i];
+}
+
+__attribute__((target("avx512f"))) void bitwiseOrAvx512(uint64_t *target,
+                                                        const uint64_t *source,
+                                                        size_t numWords) {
+    for (size_t i = 0; i < numWords; i += 8) {
+        const size_t numLoaded = std::min<size_t>(8, numWords - i);
+        const __mmask8 mask = static_cast<__mmask8>((1u << numLoaded) - 1);
+        const __m512i targetWords = _mm512_maskz_loadu_epi64(mask, target + i);
+        const __m512i sourceWords = _mm512_maskz_loadu_epi64(mask, source + i);
+
+        _mm512_mask_storeu_epi64(target + i, mask, _mm512_or_si512(targetWords, sourceWords));
+    }
+}
+
+/*
+ * The AVX-512 hash runs MurmurHash64A for 8 seeds at once, one per lane, and mixes the blocks
+ * of the data once for all the seeds. AVX2 has no 64-bit multiplication, and emulating it is
+ * no faster than the scalar hash.
+ */
+
+__attribute__((target("avx512f,avx512dq"))) void murmur64AAvx512(const void *data,
+                                                                 size_t sizeInBytes,
+                                                                 const uint64_t *seeds,
+                                                                 uint64_t *hashes,
+                                                                 size_t numSeeds) {
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    const size_t numBlocks = sizeInBytes / 8;
+    const size_t tailSize = sizeInBytes % 8;
+    const __m512i multiplier = _mm512_set1_epi64(Hash::murmurMultiplier);
+
+    for (size_t first = 0; first < numSeeds; first += 8) {
+        const size_t numLanes = std::min<size_t>(8, numSeeds - first);
+        const __mmask8 mask = static_cast<__mmask8>((1u << numLanes) - 1);
+        __m512i h = _mm512_xor_si512(_mm512_maskz_loadu_epi64(mask, seeds + first),
+                                     _mm512_set1_epi64(sizeInBytes * Hash::murmurMultiplier));
+
+        for (size_t block = 0; block < numBlocks; ++block) {
+            const __m512i k = _mm512_set1_epi64(Hash::murmurBlock(bytes + block * 8));
+
+            h = _mm512_mullo_epi64(_mm512_xor_si512(h, k), multiplier);
+        }
+
+        if (tailSize != 0) {
+            const __m512i tail =
+                _mm512_set1_epi64(Hash::murmurTail(bytes + numBlocks * 8, tailSize));
+
+            h = _mm512_mullo_epi64(_mm512_xor_si512(h, tail), multiplier);
+        }
+
+        // Shifts with a full mask, since GCC warns about the undefined values of plain ones
+        h = _mm512_xor_si512(h, _mm512_maskz_srli_epi64(0xff, h, Hash::murmurShift));
+        h = _mm512_mullo_epi64(h, multiplier);
+        h = _mm512_xor_si512(h, _mm512_maskz_srli_epi64(0xff, h, Hash::murmurShift));
+
+        _mm512_mask_storeu_epi64(hashes + first, mask, h);
+    }
+}
+
+#endif // CAKE_SIMD_X86
+
+struct Kernels {
+    uint64_t (*popcount)(const uint64_t *words, size_t numWords);
+    void (*bitwiseOr)(uint64_t *target, const uint64_t *source, size_t numWords);
+    void (*murmur64A)(const void *data, size_t sizeInBytes, const uint64_t *seeds,
+                      uint64_t *hashes, size_t numSeeds);
+};
+
+/// Kernels of every level, in the order of Level. Levels without a kernel of their own use
+/// that of the previous level.
+#ifdef CAKE_SIMD_X86
+const Kernels kernelsByLevel[] = {
+    {popcountGeneric, bitwiseOrGeneric, murmur64AGeneric},
+    {popcountSse42, bitwiseOrGeneric, murmur64AGeneric},
+    {popcountAvx2, bitwiseOrAvx2, murmur64AGeneric},
+    {popcountAvx512, bitwiseOrAvx512, murmur64AAvx512},
+};
+#else
+const Kernels kernelsByLevel[] = {
+    {popcountGeneric, bitwiseOrGeneric, murmur64AGeneric},
+    {popcountGeneric, bitwiseOrGeneric, murmur64AGeneric},
+    {popcountGeneric, bitwiseOrGeneric, murmur64AGeneric},
+    {popcountGeneric, bitwiseOrGeneric, murmur64AGeneric},
+};
+#endif
+
+Level detectLevel() {
+#ifdef CAKE_SIMD_X86
+    // These also check that the operating system saves the AVX registers
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512dq"))
+        return Level::Avx512;
+
+    if (__builtin_cpu_supports("avx2"))
+        return Level::Avx2;
+
+    if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt"))
+        return Level::Sse42;
+#endif
+
+    return Level::Generic;
+}
+
+std::atomic<Level> &activeLevelStorage() {
+    static std::atomic<Level> level(supportedLevel());
+
+    return level;
+}
+
+const Kernels &kernels() {
+    return kernelsByLevel[static_cast<size_t>(
+        activeLevelStorage().load(std::memory_order_relaxed))];
+}
+
+} // namespace
+
+Level supportedLevel() {
+    static const Level level = detectLevel();
+
+    return level;
+}
+
+Level activeLevel() { return activeLevelStorage().load(std::memory_order_relaxed); }
+
+bool setLevel(Level level) {
+    if (level > supportedLevel())
+        return false;
+
+    activeLevelStorage().store(level, std::memory_order_relaxed);
+
+    return true;
+}
+
+const char *levelName(Level level) {
+    switch (level) {
+    case Level::Generic:
+        return "generic";
+    case Level::Sse42:
+        return "sse4.2";
+    case Level::Avx2:
+        return "avx2";
+    case Level::Avx512:
+        return "avx512";
+    }
+
+    return "unknown";
+}
+
+uint64_t popcount(const uint64_t *words, size_t numWords) {
+    return kernels().popcount(words, numWords);
+}
+
+void bitwiseOr(uint64_t *target, const uint64_t *source, size_t numWords) {
+    kernels().bitwiseOr(target, source, numWords);
+}
+
+void murmur64A(const void *data, size_t sizeInBytes, const uint64_t *seeds, uint64_t *hashes,
+               size_t numSeeds) {
+    kernels().murmur64A(data, sizeInBytes, seeds, hashes, numSeeds);
+}
+
+} // namespace Simd
+} // namespace cake
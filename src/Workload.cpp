@@ -0,0 +1,208 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cake/Workload.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iterator>
+#include <unordered_set>
+#include <utility>
+
+#include <cake/Hash.h>
+
+namespace cake {
+
+namespace {
+const char *const onsets[] = {"",  "b", "c",  "d",  "f",  "g",  "h",  "k",  "l",  "m",
+                              "n", "p", "r",  "s",  "t",  "v",  "st", "tr", "ch", "sh"};
+const char *const vowels[] = {"a", "e", "i", "o", "u", "ea", "ou"};
+const char *const codas[] = {"", "", "", "n", "r", "s", "t", "l"};
+const char *const topLevelDomains[] = {"com", "com", "com", "org", "net", "io", "de"};
+
+template <typename TArray> const char *pick(const TArray &array, std::mt19937_64 &generator) {
+    const size_t size = std::size(array);
+
+    return array[std::uniform_int_distribution<size_t>(0, size - 1)(generator)];
+}
+
+/// A word of 1 to 4 syllables, mostly 2, as in English
+std::string randomWord(std::mt19937_64 &generator) {
+    const uint64_t percentile = generator() % 100;
+    const size_t count = percentile < 30 ? 1 : percentile < 70 ? 2 : percentile < 90 ? 3 : 4;
+    std::string word;
+
+    for (size_t i = 0; i < count; ++i) {
+        word += pick(onsets, generator);
+        word += pick(vowels, generator);
+        word += pick(codas, generator);
+    }
+
+    return word;
+}
+
+/// Distinct words for a vocabulary of a given size. Repeated words are drawn again, so large
+/// vocabularies have more long words than randomWord() gives, as the short ones run out.
+std::vector<std::string> vocabulary(size_t size, std::mt19937_64 &generator) {
+    std::vector<std::string> words;
+    std::unordered_set<std::string> seen;
+
+    words.reserve(size);
+    seen.reserve(size);
+
+    while (words.size() < size) {
+        std::string word = randomWord(generator);
+
+        if (seen.insert(word).second)
+            words.push_back(std::move(word));
+    }
+
+    return words;
+}
+} // namespace
+
+ZipfianGenerator::ZipfianGenerator(uint64_t numKeys, double skew, uint64_t seed)
+    : m_generator(seed), m_uniform(0.0, 1.0), m_numKeys(std::max(uint64_t(1), numKeys)),
+      m_skew(std::clamp(skew, 0.0, 0.999)), m_zeta(0.0), m_alpha(1.0 / (1.0 - m_skew)),
+      m_eta(0.0), m_secondCutoff(1.0 + std::pow(2.0, -m_skew)) {
+    for (uint64_t rank = 1; rank <= m_numKeys; ++rank)
+        m_zeta += std::pow(static_cast<double>(rank), -m_skew);
+
+    // With fewer keys, next() never gets past the two first ones
+    if (m_numKeys > 2) {
+        m_eta = (1.0 - std::pow(2.0 / static_cast<double>(m_numKeys), 1.0 - m_skew)) /
+                (1.0 - m_secondCutoff / m_zeta);
+    }
+}
+
+uint64_t ZipfianGenerator::next() {
+    const double u = m_uniform(m_generator);
+    const double scaled = u * m_zeta;
+
+    if (scaled < 1.0)
+        return 0;
+
+    if (scaled < m_secondCutoff)
+        return 1;
+
+    const auto key = static_cast<uint64_t>(static_cast<double>(m_numKeys) *
+                                           std::pow(m_eta * u - m_eta + 1.0, m_alpha));
+
+    return std::min(key, m_numKeys - 1);
+}
+
+uint64_t ScrambledZipfianGenerator::next() {
+    return Hash::murmur64A(m_zipfian.next(), m_seed) % m_zipfian.numKeys();
+}
+
+TemporalLocalityGenerator::TemporalLocalityGenerator(uint64_t workingSetSize,
+                                                     size_t phaseLength, uint64_t shift,
+                                                     double skew, uint64_t seed)
+    : m_offsets(workingSetSize, skew, seed),
+      m_phaseLength(std::max(static_cast<size_t>(1), phaseLength)), m_shift(shift),
+      m_numAccesses(0), m_base(0) {}
+
+uint64_t TemporalLocalityGenerator::next() {
+    if (m_numAccesses == m_phaseLength) {
+        m_numAccesses = 0;
+        m_base += m_shift;
+    }
+
+    ++m_numAccesses;
+
+    return m_base + m_offsets.next();
+}
+
+namespace Corpus {
+
+std::vector<std::string> words(size_t numWords, uint64_t seed) {
+    std::mt19937_64 generator(seed);
+    const auto vocabularyWords = vocabulary(std::max(numWords / 4, size_t(16)), generator);
+    ZipfianGenerator frequencies(vocabularyWords.size(), 0.99, seed);
+    std::vector<std::string> result;
+
+    result.reserve(numWords);
+
+    for (size_t i = 0; i < numWords; ++i)
+        result.push_back(vocabularyWords[frequencies.next()]);
+
+    return result;
+}
+
+std::vector<std::string> urls(size_t numUrls, uint64_t seed) {
+    std::mt19937_64 generator(seed);
+    std::vector<std::string> hosts = vocabulary(std::max(numUrls / 50, size_t(8)), generator);
+    const auto segments = vocabulary(std::max(numUrls / 10, size_t(16)), generator);
+    ZipfianGenerator hostFrequencies(hosts.size(), 0.99, seed);
+    ScrambledZipfianGenerator segmentFrequencies(segments.size(), 0.8, seed);
+    std::uniform_int_distribution<size_t> numSegments(1, 3);
+    std::uniform_int_distribution<uint32_t> id(1, 1000000);
+    std::vector<std::string> result;
+
+    for (auto &host : hosts)
+        host = "https://www." + host + "." + pick(topLevelDomains, generator);
+
+    result.reserve(numUrls);
+
+    for (size_t i = 0; i < numUrls; ++i) {
+        std::string url = hosts[hostFrequencies.next()];
+        const size_t count = numSegments(generator);
+
+        for (size_t segment = 0; segment < count; ++segment)
+            url += "/" + segments[segmentFrequencies.next()];
+
+        if (generator() % 2 == 0)
+            url += "?id=" + std::to_string(id(generator));
+
+        result.push_back(std::move(url));
+    }
+
+    return result;
+}
+
+std::vector<std::string> uuids(size_t numUuids, uint64_t seed) {
+    std::mt19937_64 generator(seed);
+    std::vector<std::string> result;
+
+    result.reserve(numUuids);
+
+    for (size_t i = 0; i < numUuids; ++i) {
+        const uint64_t high = (generator() & ~uint64_t(0xf000)) | 0x4000; // Version 4
+        const uint64_t low = (generator() & ~(uint64_t(3) << 62)) | (uint64_t(2) << 62);
+        char uuid[37];
+
+        std::snprintf(uuid, sizeof(uuid), "%08x-%04x-%04x-%04x-%012llx",
+                      static_cast<unsigned>(high >> 32), static_cast<unsigned>(high >> 16 & 0xffff),
+                      static_cast<unsigned>(high & 0xffff), static_cast<unsigned>(low >> 48),
+                      static_cast<unsigned long long>(low & 0xffffffffffffULL));
+        result.emplace_back(uuid);
+    }
+
+    return result;
+}
+
+} // namespace Corpus
+
+} // namespace cake
@@ -0,0 +1,127 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <cake/BitVector.h>
+
+TEST(BitVectorTest, empty) {
+    std::vector<uint64_t> image;
+    cake::BitVector bitVector;
+
+    cake::BitVector::appendImage(image, {});
+
+    EXPECT_EQ(bitVector.view(image.data(), image.size()), image.size());
+    EXPECT_EQ(bitVector.size(), 0);
+    EXPECT_EQ(bitVector.numOnes(), 0);
+    EXPECT_EQ(bitVector.rank1(0), 0);
+}
+
+TEST(BitVectorTest, rankAndSelect) {
+    std::mt19937 generator(3);
+
+    for (size_t numBits : {1, 63, 64, 65, 511, 512, 513, 5000}) {
+        std::vector<bool> bits(numBits);
+        std::vector<size_t> ones;
+
+        for (size_t i = 0; i < numBits; ++i) {
+            bits[i] = generator() % 3 == 0;
+
+            if (bits[i])
+                ones.push_back(i);
+        }
+
+        std::vector<uint64_t> image;
+        cake::BitVector bitVector;
+
+        cake::BitVector::appendImage(image, bits);
+        ASSERT_EQ(bitVector.view(image.data(), image.size()), image.size());
+        EXPECT_EQ(bitVector.size(), numBits);
+        EXPECT_EQ(bitVector.numOnes(), ones.size());
+
+        size_t rank = 0;
+
+        for (size_t i = 0; i < numBits; ++i) {
+            EXPECT_EQ(bitVector[i], bits[i]);
+            EXPECT_EQ(bitVector.rank1(i), rank);
+            rank += bits[i];
+        }
+
+        EXPECT_EQ(bitVector.rank1(numBits), rank);
+
+        for (size_t k = 0; k < ones.size(); ++k)
+            EXPECT_EQ(bitVector.select1(k), ones[k]);
+    }
+}
+
+TEST(BitVectorTest, truncatedImage) {
+    std::vector<uint64_t> image;
+    cake::BitVector bitVector;
+
+    cake::BitVector::appendImage(image, std::vector<bool>(1000, true));
+
+    EXPECT_EQ(bitVector.view(image.data(), image.size() - 1), 0);
+    EXPECT_EQ(bitVector.view(image.data(), 0), 0);
+
+    image[0] = ~uint64_t(0);
+    EXPECT_EQ(bitVector.view(image.data(), image.size()), 0);
+}
+
+TEST(BitVectorTest, corruptRanks) {
+    std::vector<bool> bits(1000);
+
+    for (size_t i = 0; i < bits.size(); i += 3)
+        bits[i] = true;
+
+    std::vector<uint64_t> valid;
+    cake::BitVector bitVector;
+
+    cake::BitVector::appendImage(valid, bits);
+    ASSERT_EQ(bitVector.view(valid.data(), valid.size()), valid.size());
+
+    // Bits that do not match the stored ranks
+    auto image = valid;
+
+    image[1] = 0;
+    EXPECT_EQ(bitVector.view(image.data(), image.size()), 0);
+
+    // A stored rank or total that does not match the bits
+    image = valid;
+    ++image.back();
+    EXPECT_EQ(bitVector.view(image.data(), image.size()), 0);
+
+    // A bit set past the end, counted in the total
+    image = valid;
+    image[1 + 1000 / 64] |= uint64_t(1) << 63;
+    ++image.back();
+    EXPECT_EQ(bitVector.view(image.data(), image.size()), 0);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
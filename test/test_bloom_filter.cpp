@@ -22,6 +22,8 @@
  * SOFTWARE.
  */
 
+#include <string>
+
 #include <gtest/gtest.h>
 
 #include <cake/BloomFilter.h>
@@ -86,6 +88,62 @@ TEST(BloomFilterTest, clear) {
     EXPECT_FALSE(bloomFilter.contains(10));
 }
 
+TEST(BloomFilterTest, merge) {
+    cake::BloomFilter evens(1000, 0.01);
+    cake::BloomFilter odds(1000, 0.01);
+
+    for (int i = 0; i < 1000; i += 2) {
+        evens.add(i);
+        odds.add(i + 1);
+    }
+
+    const double occupancy = evens.occupancy();
+
+    EXPECT_TRUE(evens.merge(odds));
+    EXPECT_GT(evens.occupancy(), occupancy);
+
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_TRUE(evens.contains(i));
+
+    // Filters of different sizes cannot be merged
+    cake::BloomFilter other(2000, 0.01);
+
+    EXPECT_FALSE(evens.merge(other));
+}
+
+TEST(BloomFilterTest, occupancy) {
+    cake::BloomFilter bloomFilter(1000, 0.01);
+
+    EXPECT_EQ(bloomFilter.occupancy(), 0.0);
+
+    bloomFilter.add(7);
+    EXPECT_GT(bloomFilter.occupancy(), 0.0);
+    EXPECT_LE(bloomFilter.occupancy(), 1.0);
+
+    bloomFilter.clear();
+    EXPECT_EQ(bloomFilter.occupancy(), 0.0);
+}
+
+TEST(BloomFilterTest, sameBitsOnEveryLevel) {
+    // Enough hashes for strings to be hashed in batches where AVX-512 is available
+    cake::BloomFilter generic(1000, 0.0001);
+    cake::BloomFilter supported(1000, 0.0001);
+
+    ASSERT_TRUE(cake::Simd::setLevel(cake::Simd::Level::Generic));
+
+    for (int i = 0; i < 1000; ++i)
+        generic.add("element" + std::to_string(i));
+
+    cake::Simd::setLevel(cake::Simd::supportedLevel());
+
+    for (int i = 0; i < 1000; ++i) {
+        supported.add("element" + std::to_string(i));
+        EXPECT_TRUE(generic.contains("element" + std::to_string(i)));
+    }
+
+    EXPECT_EQ(generic.occupancy(), supported.occupancy());
+}
+
 TEST(BloomFilterTest, falsePositiveRate) {
     double falsePositiveRate = 0.01;
 
@@ -0,0 +1,165 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <cake/CacheSnapshot.h>
+#include <cake/LRUCache.h>
+#include <cake/LoadingCache.h>
+
+namespace {
+struct Point {
+    int x;
+    int y;
+};
+
+struct PointSerializer {
+    static void write(std::ostream &output, const Point &point) {
+        cake::Serializer<int>::write(output, point.x);
+        cake::Serializer<int>::write(output, point.y);
+    }
+
+    static bool read(std::istream &input, Point &point) {
+        return cake::Serializer<int>::read(input, point.x) &&
+               cake::Serializer<int>::read(input, point.y);
+    }
+};
+} // namespace
+
+TEST(CacheSnapshotTest, writeAndRead) {
+    const std::vector<std::pair<std::string, double>> entries = {
+        {"one", 1.0}, {"", 2.0}, {std::string(10000, 'x'), 3.0}};
+    std::stringstream stream;
+
+    EXPECT_TRUE(cake::CacheSnapshot::write(stream, entries));
+
+    std::vector<std::pair<std::string, double>> actual;
+    EXPECT_TRUE((cake::CacheSnapshot::read<std::string, double>(
+        stream, [&actual](const std::string &key, double value) {
+            actual.emplace_back(key, value);
+            return true;
+        })));
+
+    EXPECT_EQ(entries, actual);
+}
+
+TEST(CacheSnapshotTest, invalidSnapshot) {
+    const auto onEntry = [](int, int) { return true; };
+
+    std::stringstream empty;
+    EXPECT_FALSE((cake::CacheSnapshot::read<int, int>(empty, onEntry)));
+
+    std::stringstream garbage("this is not a snapshot");
+    EXPECT_FALSE((cake::CacheSnapshot::read<int, int>(garbage, onEntry)));
+
+    std::stringstream stream;
+    cake::CacheSnapshot::write(stream, std::vector<std::pair<int, int>>{{1, 1}, {2, 2}});
+    std::stringstream truncated(stream.str().substr(0, stream.str().size() - 1));
+    EXPECT_FALSE((cake::CacheSnapshot::read<int, int>(truncated, onEntry)));
+}
+
+TEST(CacheSnapshotTest, preserveRecencyOrder) {
+    cake::LRUCache<int, std::string> cache(4);
+    cache.insert(1, "One");
+    cache.insert(2, "Two");
+    cache.insert(3, "Three");
+    cache.insert(4, "Four");
+    cache.contains(2); // 2 4 3 1
+
+    std::stringstream stream;
+    EXPECT_TRUE(cache.saveSnapshot(stream));
+
+    cake::LRUCache<int, std::string> restored(4);
+    EXPECT_TRUE(restored.loadSnapshot(stream));
+    EXPECT_EQ(cache.entries(), restored.entries());
+
+    restored.insert(5, "Five"); // 5 2 4 3
+    EXPECT_FALSE(restored.contains(1));
+    EXPECT_TRUE(restored.contains(3));
+}
+
+TEST(CacheSnapshotTest, loadIntoSmallerCache) {
+    cake::LRUCache<int, std::string> cache(4);
+    for (int i = 1; i <= 4; ++i)
+        cache.insert(i, std::to_string(i)); // 4 3 2 1
+
+    std::stringstream stream;
+    cache.saveSnapshot(stream);
+
+    cake::LRUCache<int, std::string> restored(3);
+    restored.insert(7, "7");
+    EXPECT_TRUE(restored.loadSnapshot(stream));
+
+    const std::vector<std::pair<int, std::string>> expected = {{7, "7"}, {4, "4"}, {3, "3"}};
+    EXPECT_EQ(expected, restored.entries());
+}
+
+TEST(CacheSnapshotTest, customSerializer) {
+    cake::LRUCache<int, Point> cache(2);
+    cache.insert(1, Point{1, 2});
+    cache.insert(2, Point{3, 4});
+
+    std::stringstream stream;
+    EXPECT_TRUE((cache.saveSnapshot<cake::Serializer<int>, PointSerializer>(stream)));
+
+    cake::LRUCache<int, Point> restored(2);
+    EXPECT_TRUE((restored.loadSnapshot<cake::Serializer<int>, PointSerializer>(stream)));
+    ASSERT_NE(nullptr, restored.find(1));
+    EXPECT_EQ(2, restored.find(1)->y);
+    EXPECT_EQ(3, restored.find(2)->x);
+}
+
+TEST(CacheSnapshotTest, loadingCache) {
+    int numLoads = 0;
+    cake::LoadingCache<int, std::string> cache(10, [&numLoads](int key) {
+        ++numLoads;
+        return std::to_string(key);
+    });
+
+    cache.get(1);
+    cache.get(2);
+
+    std::stringstream stream;
+    EXPECT_TRUE(cache.saveSnapshot(stream));
+
+    cake::LoadingCache<int, std::string> restored(10, [&numLoads](int key) {
+        ++numLoads;
+        return std::to_string(key);
+    });
+    EXPECT_TRUE(restored.loadSnapshot(stream));
+    EXPECT_EQ(2, restored.size());
+    EXPECT_EQ("1", restored.get(1));
+    EXPECT_EQ("2", restored.get(2));
+    EXPECT_EQ(2, numLoads);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,136 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <chrono>
+#include <numeric>
+#include <string>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include <cake/CacheStats.h>
+#include <cake/LRUCache.h>
+
+namespace {
+template <class TKey, class TValue>
+using StatsCache = cake::LRUCache<TKey, TValue, cake::UnitWeigher, cake::CacheStatsRecorder>;
+} // namespace
+
+TEST(CacheStatsTest, disabledRecorder) {
+    cake::NoCacheStats recorder;
+
+    recorder.recordHit();
+    recorder.recordEviction();
+    const auto stats = recorder.snapshot();
+
+    EXPECT_EQ(0, stats.hits);
+    EXPECT_EQ(0, stats.evictions);
+    EXPECT_EQ(0.0, stats.hitRatio());
+}
+
+TEST(CacheStatsTest, policies) {
+    // Statistics are part of the type, so caches with and without them can be mixed freely
+    StatsCache<int, std::string> withStats(2);
+    cake::LRUCache<int, std::string> withoutStats(2);
+
+    withStats.insert(1, "One");
+    withStats.contains(1);
+    withoutStats.insert(1, "One");
+    withoutStats.contains(1);
+
+    EXPECT_EQ(1, withStats.stats().hits);
+    EXPECT_EQ(0, withoutStats.stats().hits);
+
+    // The disabled policy takes no space in the cache
+    static_assert(std::is_empty_v<cake::NoCacheStats>);
+    EXPECT_EQ(sizeof(withStats), sizeof(withoutStats) + sizeof(cake::CacheStatsRecorder));
+}
+
+TEST(CacheStatsTest, lookups) {
+    StatsCache<std::string, int> cache(2);
+
+    cache.insert("one", 1);
+    cache.contains("one");
+    cache.find("one");
+    cache["one"];
+    cache.contains("two");
+    cache.find("two");
+    cache["two"];
+
+    const auto stats = cache.stats();
+    EXPECT_EQ(3, stats.hits);
+    EXPECT_EQ(3, stats.misses);
+    EXPECT_EQ(2, stats.inserts);
+    EXPECT_EQ(0.5, stats.hitRatio());
+
+    const uint64_t numSampled =
+        std::accumulate(stats.accessLatencies.begin(), stats.accessLatencies.end(),
+                        static_cast<uint64_t>(0));
+    EXPECT_EQ(1, numSampled);
+}
+
+TEST(CacheStatsTest, removalCauses) {
+    using namespace std::chrono_literals;
+    StatsCache<std::string, int> cache(2);
+    const auto start = std::chrono::steady_clock::now();
+
+    cache.expire(start);
+    cache.insert("one", 1);
+    cache.insert("one", 11);
+    cache.insert("two", 2, 1s);
+    cache.insert("three", 3);
+    cache.insert("four", 4, 1s);
+    cache.remove("three");
+    // Deadlines are measured from the clock at insertion, a little after start
+    cache.expire(start + 2s);
+
+    const auto stats = cache.stats();
+    EXPECT_EQ(5, stats.inserts);
+    EXPECT_EQ(1, stats.replacements);
+    EXPECT_EQ(2, stats.evictions);
+    EXPECT_EQ(1, stats.explicitRemovals);
+    EXPECT_EQ(1, stats.expirations);
+    EXPECT_EQ(0, cache.size());
+}
+
+TEST(CacheStatsTest, latencySampling) {
+    StatsCache<std::string, int> cache(10);
+    const uint64_t numLookups = 100 * cake::CacheStatsRecorder::latencySampleInterval;
+
+    for (uint64_t i = 0; i < numLookups; ++i)
+        cache.contains("key");
+
+    const auto stats = cache.stats();
+    const uint64_t numSampled =
+        std::accumulate(stats.accessLatencies.begin(), stats.accessLatencies.end(),
+                        static_cast<uint64_t>(0));
+
+    EXPECT_EQ(numLookups, stats.misses);
+    EXPECT_EQ(100, numSampled);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
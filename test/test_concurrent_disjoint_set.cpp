@@ -0,0 +1,107 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <atomic>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <cake/ConcurrentDisjointSet.h>
+#include <cake/DenseDisjointSet.h>
+
+TEST(ConcurrentDisjointSetTest, join) {
+    cake::ConcurrentDisjointSet<int> disjointSet(4);
+
+    EXPECT_EQ(disjointSet.size(), 4);
+    EXPECT_EQ(disjointSet.find(3), 3);
+
+    EXPECT_TRUE(disjointSet.join(0, 1));
+    EXPECT_FALSE(disjointSet.join(1, 0));
+    EXPECT_TRUE(disjointSet.join(3, 2));
+    EXPECT_FALSE(disjointSet.sameSet(0, 3));
+
+    EXPECT_TRUE(disjointSet.join(1, 3));
+    EXPECT_TRUE(disjointSet.sameSet(2, 0));
+    EXPECT_EQ(disjointSet.find(2), disjointSet.find(1));
+}
+
+TEST(ConcurrentDisjointSetTest, outOfRange) {
+    cake::ConcurrentDisjointSet<long long> disjointSet(2);
+
+    EXPECT_FALSE(disjointSet.join(-1, 0));
+    EXPECT_FALSE(disjointSet.join(0, 2));
+    EXPECT_EQ(disjointSet.find(5), 5);
+    EXPECT_TRUE(disjointSet.sameSet(5, 5));
+    EXPECT_FALSE(disjointSet.sameSet(0, 5));
+}
+
+TEST(ConcurrentDisjointSetTest, concurrentJoins) {
+    const int numElements = 20000;
+    const int numThreads = 8;
+    std::mt19937 generator(11);
+    std::uniform_int_distribution<int> element(0, numElements - 1);
+    std::vector<std::pair<int, int>> edges;
+
+    for (int i = 0; i < numElements; ++i)
+        edges.emplace_back(element(generator), element(generator));
+
+    cake::ConcurrentDisjointSet<int> concurrent(numElements);
+    cake::DenseDisjointSet<int> expected(numElements);
+    std::atomic<size_t> numMerges(0);
+    std::vector<std::thread> threads;
+
+    for (const auto &[element1, element2] : edges)
+        expected.join(element1, element2);
+
+    // Every thread joins every edge, so the same sets are merged concurrently
+    for (int thread = 0; thread < numThreads; ++thread) {
+        threads.emplace_back([&, thread]() {
+            for (size_t i = 0; i < edges.size(); ++i) {
+                const auto &edge = edges[(i + thread * edges.size() / numThreads) % edges.size()];
+
+                if (concurrent.join(edge.first, edge.second))
+                    numMerges.fetch_add(1);
+
+                concurrent.sameSet(edge.second, edge.first);
+            }
+        });
+    }
+
+    for (auto &thread : threads)
+        thread.join();
+
+    // Each merge was done exactly once
+    EXPECT_EQ(numMerges.load(), numElements - expected.numSets());
+
+    for (int i = 0; i < numElements; i += 7)
+        EXPECT_EQ(concurrent.sameSet(i, 0), expected.sameSet(i, 0));
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,150 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <cake/ConcurrentPrefixTree.h>
+#include <cake/PrefixTree.h>
+
+TEST(ConcurrentPrefixTreeTest, constructEmpty) {
+    cake::ConcurrentPrefixTree<std::string> trie;
+
+    EXPECT_EQ(trie.size(), 0);
+    EXPECT_TRUE(trie.query("a").empty());
+}
+
+TEST(ConcurrentPrefixTreeTest, addAndRemove) {
+    cake::ConcurrentPrefixTree<std::string> trie({"apple", "brave", "application", "cake"});
+
+    EXPECT_EQ(trie.size(), 4);
+    EXPECT_FALSE(trie.add("apple"));
+    EXPECT_FALSE(trie.add(""));
+    EXPECT_TRUE(trie.add("app"));
+    EXPECT_EQ(trie.query("app"), std::vector<std::string>({"app", "apple", "application"}));
+
+    EXPECT_FALSE(trie.remove("ap"));
+    EXPECT_FALSE(trie.remove("cakes"));
+    EXPECT_TRUE(trie.remove("apple"));
+    EXPECT_FALSE(trie.remove("apple"));
+    EXPECT_TRUE(trie.remove("app"));
+    EXPECT_EQ(trie.query("a"), std::vector<std::string>({"application"}));
+    EXPECT_EQ(trie.query(""), std::vector<std::string>());
+    EXPECT_EQ(trie.size(), 3);
+}
+
+TEST(ConcurrentPrefixTreeTest, matchesPrefixTree) {
+    std::mt19937 generator(13);
+    cake::PrefixTree<std::string> expected;
+    cake::ConcurrentPrefixTree<std::string> trie;
+
+    for (int i = 0; i < 3000; ++i) {
+        std::string word(1 + generator() % 5, ' ');
+
+        for (auto &c : word)
+            c = "ab\xff"[generator() % 3];
+
+        if (i % 3 == 0)
+            EXPECT_EQ(trie.remove(word), expected.remove(word));
+        else
+            EXPECT_EQ(trie.add(word), expected.add(word));
+    }
+
+    EXPECT_EQ(trie.size(), expected.size());
+
+    for (const std::string prefix : {"a", "b", "ab", "\xff", "ba\xff"})
+        EXPECT_EQ(trie.query(prefix), expected.query(prefix));
+}
+
+TEST(ConcurrentPrefixTreeTest, readersDuringUpdates) {
+    // "stable" words are never removed, "churn" words are added and removed all the time
+    cake::ConcurrentPrefixTree<std::string> trie;
+    std::vector<std::string> stable;
+
+    for (int i = 0; i < 100; ++i) {
+        stable.push_back("stable" + std::to_string(i));
+        trie.add(stable.back());
+    }
+
+    std::sort(stable.begin(), stable.end());
+
+    std::atomic<bool> done(false);
+    std::atomic<size_t> failures(0);
+    std::vector<std::thread> readers;
+
+    for (int reader = 0; reader < 4; ++reader) {
+        readers.emplace_back([&]() {
+            while (!done.load()) {
+                if (trie.query("stable") != stable)
+                    ++failures;
+
+                const auto churn = trie.query("churn");
+
+                if (!std::is_sorted(churn.begin(), churn.end()))
+                    ++failures;
+            }
+        });
+    }
+
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 100; ++i)
+            trie.add("churn" + std::to_string(i));
+
+        for (int i = 0; i < 100; ++i)
+            trie.remove("churn" + std::to_string(i));
+    }
+
+    done = true;
+
+    for (auto &reader : readers)
+        reader.join();
+
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_EQ(trie.size(), stable.size());
+    EXPECT_TRUE(trie.query("churn").empty());
+}
+
+TEST(ConcurrentPrefixTreeTest, memoryUsage) {
+    cake::ConcurrentPrefixTree<std::string> trie;
+    const size_t emptyUsage = trie.memoryUsage();
+
+    EXPECT_TRUE(trie.add("apple"));
+    EXPECT_TRUE(trie.add("apricot"));
+    const size_t usage = trie.memoryUsage();
+    EXPECT_GT(usage, emptyUsage);
+
+    // Without readers, the replaced nodes are freed right away
+    EXPECT_TRUE(trie.remove("apricot"));
+    EXPECT_LT(trie.memoryUsage(), usage);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,83 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <cake/CountMinSketch.h>
+
+TEST(CountMinSketchTest, constructor) {
+    {
+        cake::CountMinSketch sketch(0);
+        EXPECT_EQ(16, sketch.width());
+    }
+    {
+        cake::CountMinSketch sketch(1000);
+        EXPECT_EQ(1024, sketch.width());
+    }
+}
+
+TEST(CountMinSketchTest, count) {
+    cake::CountMinSketch sketch(1000);
+
+    EXPECT_EQ(0, sketch.count(7));
+
+    for (int i = 0; i < 5; ++i)
+        sketch.increment(7);
+    sketch.increment(std::string("eight"));
+
+    EXPECT_EQ(5, sketch.count(7));
+    EXPECT_EQ(1, sketch.count(std::string("eight")));
+}
+
+TEST(CountMinSketchTest, neverUndercounts) {
+    cake::CountMinSketch sketch(64);
+
+    for (int i = 0; i < 1000; ++i) {
+        for (int j = 0; j <= i % 10; ++j)
+            sketch.increment(i);
+    }
+
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_GE(sketch.count(i), static_cast<size_t>(i % 10 + 1));
+}
+
+TEST(CountMinSketchTest, halveAndClear) {
+    cake::CountMinSketch sketch(1000);
+
+    for (int i = 0; i < 9; ++i)
+        sketch.increment(3);
+
+    sketch.halve();
+    EXPECT_EQ(4, sketch.count(3));
+
+    sketch.clear();
+    EXPECT_EQ(0, sketch.count(3));
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,124 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <limits>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <cake/DenseDisjointSet.h>
+#include <cake/DisjointSet.h>
+
+TEST(DenseDisjointSetTest, constructEmpty) {
+    cake::DenseDisjointSet<int> disjointSet;
+
+    EXPECT_EQ(disjointSet.size(), 0);
+    EXPECT_EQ(disjointSet.numSets(), 0);
+    EXPECT_EQ(disjointSet.find(7), 7);
+    EXPECT_EQ(disjointSet.setSize(7), 1);
+    EXPECT_FALSE(disjointSet.sameSet(1, 2));
+}
+
+TEST(DenseDisjointSetTest, add) {
+    cake::DenseDisjointSet<int> disjointSet(2);
+
+    EXPECT_EQ(disjointSet.add(), 2);
+    EXPECT_EQ(disjointSet.size(), 3);
+    EXPECT_EQ(disjointSet.numSets(), 3);
+    EXPECT_EQ(disjointSet.find(2), 2);
+}
+
+TEST(DenseDisjointSetTest, join) {
+    cake::DenseDisjointSet<int> disjointSet(4);
+
+    EXPECT_TRUE(disjointSet.join(0, 1));
+    EXPECT_FALSE(disjointSet.join(1, 0));
+    EXPECT_TRUE(disjointSet.join(2, 3));
+    EXPECT_EQ(disjointSet.numSets(), 2);
+    EXPECT_FALSE(disjointSet.sameSet(0, 3));
+
+    EXPECT_TRUE(disjointSet.join(1, 3));
+    EXPECT_TRUE(disjointSet.sameSet(0, 2));
+    EXPECT_EQ(disjointSet.setSize(3), 4);
+    EXPECT_EQ(disjointSet.numSets(), 1);
+
+    EXPECT_FALSE(disjointSet.join(-1, 3));
+}
+
+TEST(DenseDisjointSetTest, joinOutOfRange) {
+    cake::DenseDisjointSet<long long> disjointSet;
+
+    // Elements that were not added are rejected rather than added
+    EXPECT_FALSE(disjointSet.join(2, 9));
+    EXPECT_FALSE(disjointSet.join(0, std::numeric_limits<long long>::max()));
+    EXPECT_EQ(disjointSet.size(), 0);
+    EXPECT_EQ(disjointSet.numSets(), 0);
+
+    disjointSet.reserve(10);
+
+    while (disjointSet.size() < 10)
+        disjointSet.add();
+
+    EXPECT_TRUE(disjointSet.join(2, 9));
+    EXPECT_FALSE(disjointSet.join(9, 10));
+    EXPECT_EQ(disjointSet.size(), 10);
+    EXPECT_EQ(disjointSet.numSets(), 9);
+    EXPECT_TRUE(disjointSet.sameSet(9, 2));
+    EXPECT_EQ(disjointSet.setSize(5), 1);
+}
+
+TEST(DenseDisjointSetTest, matchesDisjointSet) {
+    const int numElements = 1000;
+    cake::DenseDisjointSet<int> dense(numElements);
+    cake::DisjointSet<int> sparse;
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<int> element(0, numElements - 1);
+
+    for (int i = 0; i < numElements; ++i)
+        sparse.add(i);
+
+    for (int i = 0; i < 800; ++i) {
+        const int element1 = element(generator);
+        const int element2 = element(generator);
+
+        EXPECT_EQ(dense.join(element1, element2), sparse.join(element1, element2));
+    }
+
+    size_t numSets = 0;
+
+    for (int i = 0; i < numElements; ++i) {
+        numSets += dense.find(i) == i;
+
+        for (int j = i + 1; j < numElements; j += 37)
+            EXPECT_EQ(dense.sameSet(i, j), sparse.find(i) == sparse.find(j));
+    }
+
+    EXPECT_EQ(dense.numSets(), numSets);
+    EXPECT_EQ(dense.memoryUsage(), sizeof(dense) + numElements * sizeof(int));
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
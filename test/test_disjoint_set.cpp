@@ -22,6 +22,10 @@
  * SOFTWARE.
  */
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include <cake/DisjointSet.h>
@@ -84,6 +88,70 @@ TEST(DisjointSetTest, join) {
     EXPECT_FALSE(disjointSet.join(id2, id4));
 }
 
+TEST(DisjointSetTest, joinAll) {
+    cake::DisjointSet<int> disjointSet;
+    const std::vector<std::pair<int, int>> edges{{1, 2}, {3, 4}, {2, 1}, {5, 5}, {4, 1}};
+
+    EXPECT_EQ(disjointSet.joinAll(edges), 3);
+    EXPECT_EQ(disjointSet.numSets(), 2);
+    EXPECT_EQ(disjointSet.setSize(disjointSet.find(3).value()), 4);
+    EXPECT_EQ(disjointSet.setSize(disjointSet.find(5).value()), 1);
+}
+
+TEST(DisjointSetTest, setSize) {
+    cake::DisjointSet<int> disjointSet;
+    const auto id1 = disjointSet.add(1);
+    const auto id2 = disjointSet.add(2);
+
+    EXPECT_EQ(disjointSet.numSets(), 2);
+    EXPECT_TRUE(disjointSet.join(id1, id2));
+    EXPECT_EQ(disjointSet.numSets(), 1);
+
+    // Both handles lead to the merged set
+    EXPECT_EQ(disjointSet.setSize(id1), 2);
+    EXPECT_EQ(disjointSet.setSize(id2), 2);
+}
+
+TEST(DisjointSetTest, components) {
+    cake::DisjointSet<int> disjointSet;
+
+    EXPECT_EQ(disjointSet.components().size(), 0);
+    EXPECT_EQ(disjointSet.components().offsets, std::vector<size_t>({0}));
+
+    disjointSet.joinAll(std::vector<std::pair<int, int>>{{1, 2}, {3, 4}, {2, 6}});
+    disjointSet.add(7);
+
+    const auto components = disjointSet.components();
+    std::vector<std::vector<int>> sets;
+
+    ASSERT_EQ(components.size(), 3);
+    ASSERT_EQ(components.offsets.size(), 4);
+    EXPECT_EQ(components.offsets.back(), 6);
+
+    for (size_t i = 0; i < components.size(); ++i) {
+        std::vector<int> set(components.members.begin() + components.offsets[i],
+                             components.members.begin() + components.offsets[i + 1]);
+
+        EXPECT_EQ(disjointSet.setSize(components.handles[i]), set.size());
+        EXPECT_EQ(disjointSet.find(set.front()).value(), components.handles[i]);
+        std::sort(set.begin(), set.end());
+        sets.push_back(set);
+    }
+
+    std::sort(sets.begin(), sets.end());
+    EXPECT_EQ(sets, std::vector<std::vector<int>>({{1, 2, 6}, {3, 4}, {7}}));
+}
+
+TEST(DisjointSetTest, memoryUsage) {
+    cake::DisjointSet<int> disjointSet;
+    const size_t emptyUsage = disjointSet.memoryUsage();
+
+    for (int i = 0; i < 100; ++i)
+        disjointSet.add(i);
+
+    EXPECT_GT(disjointSet.memoryUsage(), emptyUsage + 100 * 2 * sizeof(size_t));
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
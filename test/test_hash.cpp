@@ -63,6 +63,22 @@ TEST(HashTest, alwaysSameResult) {
     }
 }
 
+TEST(HashTest, matchesReference) {
+    // Hashes of prefixes of a string by the reference MurmurHash64A
+    const char *data = "PieceOfCake, the quick brown fox";
+    const std::pair<size_t, uint64_t> expected[] = {
+        {0, 0xf88395e73bfb1fd9ULL}, {1, 0xcd2e39eb463a2902ULL},  {7, 0xc19ae6d32a728ccfULL},
+        {8, 0x85cc060bebf955c9ULL}, {13, 0x906e4af0d73c82ffULL}, {32, 0x5e2c7741467b944eULL}};
+
+    for (const auto &[size, hash] : expected) {
+        EXPECT_EQ(cake::Hash::murmur64A(data, size, 2022), hash);
+
+        // Also from an unaligned address
+        const std::string copy = std::string(" ") + std::string(data, size);
+        EXPECT_EQ(cake::Hash::murmur64A(copy.data() + 1, size, 2022), hash);
+    }
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
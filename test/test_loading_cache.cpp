@@ -0,0 +1,263 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <cake/LoadingCache.h>
+
+namespace {
+/// Clock that only moves when told to, so that times to live are tested deterministically
+struct FakeClock {
+    using duration = std::chrono::steady_clock::duration;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<FakeClock>;
+    static constexpr bool is_steady = true;
+
+    static time_point now() { return current; }
+
+    static inline time_point current = time_point(std::chrono::hours(1));
+};
+
+using TimedCache = cake::LoadingCache<int, std::string, cake::NoCacheStats, FakeClock>;
+} // namespace
+
+TEST(LoadingCacheTest, loadOnMiss) {
+    std::atomic<int> numLoads(0);
+    cake::LoadingCache<int, std::string> cache(2, [&numLoads](int key) {
+        ++numLoads;
+        return std::to_string(key);
+    });
+
+    EXPECT_EQ(0, cache.size());
+    EXPECT_EQ("1", cache.get(1));
+    EXPECT_EQ("1", cache.get(1));
+    EXPECT_EQ(1, numLoads);
+
+    EXPECT_EQ("2", cache.get(2));
+    EXPECT_EQ("3", cache.get(3));
+    EXPECT_EQ(2, cache.size());
+    EXPECT_EQ(3, numLoads);
+
+    EXPECT_EQ("1", cache.get(1));
+    EXPECT_EQ(4, numLoads);
+
+    EXPECT_TRUE(cache.invalidate(1));
+    EXPECT_FALSE(cache.invalidate(1));
+    EXPECT_EQ("1", cache.get(1));
+    EXPECT_EQ(5, numLoads);
+}
+
+TEST(LoadingCacheTest, coalesceConcurrentMisses) {
+    std::atomic<int> numLoads(0);
+    cake::LoadingCache<int, std::string> cache(10, [&numLoads](int key) {
+        ++numLoads;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        return std::to_string(key);
+    });
+
+    std::vector<std::thread> threads;
+    std::atomic<int> numCorrect(0);
+
+    for (int i = 0; i < 16; ++i) {
+        threads.emplace_back([&cache, &numCorrect]() {
+            if (cache.get(7) == "7")
+                ++numCorrect;
+        });
+    }
+
+    for (auto &thread : threads)
+        thread.join();
+
+    EXPECT_EQ(1, numLoads);
+    EXPECT_EQ(16, numCorrect);
+}
+
+TEST(LoadingCacheTest, loaderFailure) {
+    std::atomic<int> numLoads(0);
+    cake::LoadingCache<int, std::string> cache(10, [&numLoads](int key) -> std::string {
+        if (numLoads++ == 0)
+            throw std::runtime_error("backend unavailable");
+        return std::to_string(key);
+    });
+
+    EXPECT_THROW(cache.get(1), std::runtime_error);
+    EXPECT_EQ(0, cache.size());
+    EXPECT_EQ("1", cache.get(1));
+}
+
+TEST(LoadingCacheTest, timeToLive) {
+    using namespace std::chrono_literals;
+    std::atomic<int> numLoads(0);
+    TimedCache cache(10, [&numLoads](int key) {
+        ++numLoads;
+        return std::to_string(key);
+    });
+    const auto start = FakeClock::now();
+
+    cache.setTimeToLive(10s);
+    cache.get(1);
+
+    FakeClock::current = start + 9s;
+    cache.expire();
+    cache.get(1);
+    EXPECT_EQ(1, numLoads);
+
+    FakeClock::current = start + 10s;
+    cache.expire();
+    EXPECT_EQ(0, cache.size());
+    cache.get(1);
+    EXPECT_EQ(2, numLoads);
+}
+
+TEST(LoadingCacheTest, refreshAhead) {
+    using namespace std::chrono_literals;
+    std::atomic<int> numLoads(0);
+    TimedCache cache(10, [&numLoads](int key) {
+        return std::to_string(key) + "." + std::to_string(numLoads++);
+    });
+    const auto start = FakeClock::now();
+
+    cache.setTimeToLive(10s);
+    cache.setRefreshAfter(5s);
+    EXPECT_EQ("1.0", cache.get(1));
+
+    FakeClock::current = start + 4s;
+    cache.expire();
+    EXPECT_EQ("1.0", cache.get(1));
+    EXPECT_EQ(1, numLoads);
+
+    // The stale value is served while the refresh runs in the background
+    FakeClock::current = start + 6s;
+    cache.expire();
+    EXPECT_EQ("1.0", cache.get(1));
+
+    std::string value;
+    for (int i = 0; i < 1000 && value != "1.1"; ++i) {
+        value = cache.get(1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    EXPECT_EQ("1.1", value);
+    EXPECT_EQ(2, numLoads);
+
+    // The refreshed entry lives for its own time to live
+    FakeClock::current = start + 12s;
+    cache.expire();
+    EXPECT_EQ("1.1", cache.get(1));
+}
+
+TEST(LoadingCacheTest, refreshAheadWithoutExpire) {
+    using namespace std::chrono_literals;
+    std::atomic<int> numLoads(0);
+    TimedCache cache(10, [&numLoads](int key) {
+        return std::to_string(key) + "." + std::to_string(numLoads++);
+    });
+
+    // Ages are measured with the clock, whether or not expire() is called
+    cache.setRefreshAfter(5s);
+    EXPECT_EQ("1.0", cache.get(1));
+
+    FakeClock::current += 6s;
+
+    std::string value;
+    for (int i = 0; i < 1000 && value != "1.1"; ++i) {
+        value = cache.get(1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    EXPECT_EQ("1.1", value);
+    EXPECT_EQ(2, numLoads);
+}
+
+TEST(LoadingCacheTest, failedRefreshBacksOff) {
+    using namespace std::chrono_literals;
+    std::atomic<int> numLoads(0);
+    TimedCache cache(10, [&numLoads](int key) -> std::string {
+        if (numLoads++ > 0)
+            throw std::runtime_error("backend unavailable");
+        return std::to_string(key);
+    });
+
+    cache.setRefreshAfter(5s);
+    EXPECT_EQ("1", cache.get(1));
+
+    // One refresh fails, and the next accesses serve the current value without retrying
+    FakeClock::current += 6s;
+
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ("1", cache.get(1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    EXPECT_EQ(2, numLoads);
+
+    // Until the refresh age passes again
+    FakeClock::current += 5s;
+
+    for (int i = 0; i < 1000 && numLoads < 3; ++i) {
+        EXPECT_EQ("1", cache.get(1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    EXPECT_EQ(3, numLoads);
+}
+
+TEST(LoadingCacheTest, finishedRefreshesAreForgotten) {
+    using namespace std::chrono_literals;
+    std::atomic<int> numLoads(0);
+    TimedCache cache(10, [&numLoads](int) { return std::to_string(numLoads++); });
+
+    cache.setRefreshAfter(1s);
+    cache.get(1);
+
+    size_t usage = 0;
+
+    // Without any call to expire(), the refreshes do not pile up
+    for (int refresh = 1; refresh <= 20; ++refresh) {
+        FakeClock::current += 2s;
+
+        for (int i = 0; i < 1000 && cache.get(1) != std::to_string(refresh); ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        ASSERT_EQ(std::to_string(refresh), cache.get(1));
+
+        if (refresh == 2)
+            usage = cache.memoryUsage();
+    }
+
+    EXPECT_EQ(usage, cache.memoryUsage());
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
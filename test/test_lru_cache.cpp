@@ -22,10 +22,32 @@
  * SOFTWARE.
  */
 
+#include <chrono>
+#include <string>
+#include <type_traits>
+
 #include <gtest/gtest.h>
 
 #include <cake/LRUCache.h>
 
+namespace {
+/// Clock that only moves when told to, so that times to live are tested deterministically
+struct FakeClock {
+    using duration = std::chrono::steady_clock::duration;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<FakeClock>;
+    static constexpr bool is_steady = true;
+
+    static time_point now() { return current; }
+
+    static inline time_point current = time_point(std::chrono::hours(1));
+};
+
+using TimedCache =
+    cake::LRUCache<int, std::string, cake::UnitWeigher, cake::NoCacheStats, FakeClock>;
+} // namespace
+
 TEST(LRUCacheTest, test_constructor) {
     {
     cake::LRUCache<int, std::string> cache(0);
@@ -141,6 +163,24 @@ TEST(LRUCacheTest, test_contains) {
     EXPECT_TRUE(cache.contains(2));
 }
 
+TEST(LRUCacheTest, test_find) {
+    cake::LRUCache<int, std::string> cache(2);
+
+    EXPECT_EQ(nullptr, cache.find(1));
+
+    cache.insert(1, "One");
+    cache.insert(2, "Two");
+
+    auto *value = cache.find(1); // 1 2
+    ASSERT_NE(nullptr, value);
+    EXPECT_EQ("One", *value);
+
+    *value = "Uno";
+    cache.insert(3, "Three"); // 3 1
+    EXPECT_EQ(nullptr, cache.find(2));
+    EXPECT_EQ("Uno", *cache.find(1));
+}
+
 TEST(LRUCacheTest, test_lru_eviction_policy) {
     cake::LRUCache<int, std::string> cache(4);
 
@@ -173,6 +213,280 @@ TEST(LRUCacheTest, test_lru_eviction_policy) {
     EXPECT_TRUE(cache.contains(8));
 }
 
+namespace {
+struct StringSizeWeigher {
+    size_t operator()(int, const std::string &value) const { return value.size(); }
+};
+} // namespace
+
+TEST(LRUCacheTest, test_weighted_capacity) {
+    cake::LRUCache<int, std::string, StringSizeWeigher> cache(10);
+
+    EXPECT_EQ(10, cache.maxSize());
+    EXPECT_EQ(0, cache.currentWeight());
+
+    EXPECT_TRUE(cache.insert(1, "aaa"));
+    EXPECT_TRUE(cache.insert(2, "bbb"));
+    EXPECT_TRUE(cache.insert(3, "ccc")); // 3 2 1
+    EXPECT_EQ(3, cache.size());
+    EXPECT_EQ(9, cache.currentWeight());
+
+    EXPECT_TRUE(cache.contains(1)); // 1 3 2
+    EXPECT_TRUE(cache.insert(4, "dddddd")); // 4 1
+    EXPECT_EQ(2, cache.size());
+    EXPECT_EQ(9, cache.currentWeight());
+    EXPECT_FALSE(cache.contains(2));
+    EXPECT_FALSE(cache.contains(3));
+
+    EXPECT_TRUE(cache.insert(1, "a")); // 1 4
+    EXPECT_EQ(7, cache.currentWeight());
+
+    EXPECT_TRUE(cache.remove(4));
+    EXPECT_EQ(1, cache.currentWeight());
+}
+
+TEST(LRUCacheTest, test_weighted_oversized_entry) {
+    cake::LRUCache<int, std::string, StringSizeWeigher> cache(4);
+
+    EXPECT_TRUE(cache.insert(1, "a"));
+    EXPECT_TRUE(cache.insert(2, "b"));
+
+    EXPECT_FALSE(cache.insert(3, "ccccc"));
+    EXPECT_FALSE(cache.contains(3));
+    EXPECT_EQ(2, cache.size());
+    EXPECT_EQ(2, cache.currentWeight());
+
+    EXPECT_FALSE(cache.insert(1, "aaaaa"));
+    EXPECT_FALSE(cache.contains(1));
+    EXPECT_EQ(1, cache.size());
+    EXPECT_EQ(1, cache.currentWeight());
+}
+
+TEST(LRUCacheTest, test_time_to_live) {
+    using namespace std::chrono_literals;
+    TimedCache cache(4);
+    const auto start = FakeClock::now();
+
+    cache.expire(start);
+
+    EXPECT_TRUE(cache.insert(1, "One", 10s));
+    EXPECT_TRUE(cache.insert(2, "Two", 20s));
+    EXPECT_TRUE(cache.insert(3, "Three"));
+    EXPECT_EQ(3, cache.size());
+
+    cache.expire(start + 9s);
+    EXPECT_EQ(3, cache.size());
+    EXPECT_TRUE(cache.contains(1));
+
+    cache.expire(start + 10s);
+    EXPECT_EQ(2, cache.size());
+    EXPECT_FALSE(cache.contains(1));
+
+    cache.expire(start + 1h);
+    EXPECT_EQ(1, cache.size());
+    EXPECT_FALSE(cache.contains(2));
+    EXPECT_TRUE(cache.contains(3));
+}
+
+TEST(LRUCacheTest, test_default_time_to_live) {
+    using namespace std::chrono_literals;
+    TimedCache cache(4);
+    const auto start = FakeClock::now();
+
+    EXPECT_EQ(FakeClock::duration::zero(), cache.defaultTimeToLive());
+
+    cache.expire(start);
+    cache.setDefaultTimeToLive(5s);
+    EXPECT_EQ(5s, cache.defaultTimeToLive());
+
+    cache.insert(1, "One");
+    cache[2] = "Two";
+    cache.insert(3, "Three", 1min);
+
+    // Replacing an entry restarts its time to live, and removing it cancels it
+    cache.expire(start + 3s);
+    cache.insert(1, "Uno");
+    EXPECT_TRUE(cache.remove(3));
+
+    cache.expire(start + 5s);
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_FALSE(cache.contains(2));
+    EXPECT_EQ(1, cache.size());
+
+    cache.expire(start + 8s);
+    EXPECT_EQ(0, cache.size());
+}
+
+TEST(LRUCacheTest, test_expired_entries_are_replaced) {
+    using namespace std::chrono_literals;
+    TimedCache cache(2);
+    const auto start = FakeClock::now();
+
+    cache.expire(start);
+    cache.insert(1, "One", 1s);
+    cache.insert(2, "Two", 1s);
+
+    cache.expire(start + 2s);
+    EXPECT_EQ("", cache[1]);
+    EXPECT_TRUE(cache.insert(2, "Zwei"));
+    EXPECT_EQ(2, cache.size());
+
+    cache.expire(start + 1h);
+    EXPECT_EQ(2, cache.size());
+    EXPECT_EQ("Zwei", cache[2]);
+}
+
+TEST(LRUCacheTest, test_lazy_expiration) {
+    using namespace std::chrono_literals;
+    TimedCache cache(4);
+
+    cache.insert(1, "One", 10s);
+    cache.insert(2, "Two");
+
+    // Without any call to expire(), the first lookup notices that the clock moved
+    FakeClock::current += 10s;
+
+    EXPECT_TRUE(cache.contains(2));
+    EXPECT_EQ(nullptr, cache.find(1));
+    EXPECT_EQ(1, cache.size());
+}
+
+TEST(LRUCacheTest, test_expiration_in_idle_cache) {
+    using namespace std::chrono_literals;
+    TimedCache cache(4);
+
+    cache.insert(1, "One", 10ms);
+    EXPECT_NE(nullptr, cache.find(1));
+
+    // A single lookup, long after the last one, does not return the expired entry
+    FakeClock::current += 1h;
+
+    EXPECT_EQ(nullptr, cache.find(1));
+    EXPECT_EQ(0, cache.size());
+}
+
+TEST(LRUCacheTest, test_insert_after_idle_period) {
+    using namespace std::chrono_literals;
+    TimedCache cache(4);
+    const auto start = FakeClock::now();
+
+    cache.expire();
+
+    // The deadline is measured from the time of the insertion, not from the last expire()
+    FakeClock::current = start + 1h;
+    cache.insert(1, "One", 10s);
+
+    cache.expire();
+    EXPECT_TRUE(cache.contains(1));
+
+    FakeClock::current = start + 1h + 9s;
+    cache.expire();
+    EXPECT_TRUE(cache.contains(1));
+
+    FakeClock::current = start + 1h + 10s;
+    cache.expire();
+    EXPECT_EQ(0, cache.size());
+}
+
+TEST(LRUCacheTest, test_copy) {
+    using namespace std::chrono_literals;
+    static_assert(std::is_copy_constructible_v<cake::LRUCache<int, std::string>>);
+    static_assert(std::is_copy_assignable_v<cake::LRUCache<int, std::string>>);
+
+    TimedCache cache(3);
+    const auto start = FakeClock::now();
+
+    cache.expire(start);
+    cache.insert(1, "One", 10s);
+    cache.insert(2, "Two");
+    cache.insert(3, "Three", 20s);
+
+    // The copy keeps the recency order, and evicts independently
+    TimedCache copy(cache);
+    copy.insert(4, "Four");
+    EXPECT_FALSE(copy.contains(1));
+    EXPECT_EQ(3, cache.size());
+    EXPECT_EQ("One", cache[1]);
+
+    // The copy has timers of its own
+    copy.expire(start + 20s);
+    EXPECT_EQ(2, copy.size());
+    EXPECT_TRUE(copy.contains(2));
+    EXPECT_TRUE(copy.contains(4));
+    EXPECT_EQ(3, cache.size());
+
+    TimedCache assigned(1);
+    assigned.insert(5, "Five", 1s);
+    assigned = cache;
+    EXPECT_EQ(3, assigned.maxSize());
+    EXPECT_FALSE(assigned.contains(5));
+
+    assigned.expire(start + 10s);
+    EXPECT_EQ(2, assigned.size());
+    EXPECT_FALSE(assigned.contains(1));
+    EXPECT_TRUE(assigned.contains(3));
+
+    cache.expire(start + 20s);
+    EXPECT_EQ(1, cache.size());
+    EXPECT_TRUE(cache.contains(2));
+}
+
+TEST(LRUCacheTest, test_move) {
+    using namespace std::chrono_literals;
+    TimedCache cache(3);
+
+    cache.insert(1, "One", 10s);
+    cache.insert(2, "Two");
+
+    // The moved-from cache is left empty and usable
+    TimedCache moved(std::move(cache));
+    EXPECT_EQ(2, moved.size());
+    EXPECT_EQ(0, cache.size());
+    EXPECT_EQ(0, cache.currentWeight());
+    EXPECT_EQ(nullptr, cache.find(1));
+
+    cache.insert(3, "Three", 1s);
+    EXPECT_EQ(1, cache.size());
+    EXPECT_EQ("Three", cache[3]);
+
+    TimedCache assigned(1);
+    assigned.insert(4, "Four");
+    assigned = std::move(moved);
+    EXPECT_EQ(3, assigned.maxSize());
+    EXPECT_EQ(2, assigned.size());
+    EXPECT_FALSE(assigned.contains(4));
+    EXPECT_EQ(0, moved.size());
+
+    // The timers moved along with the entries
+    FakeClock::current += 10s;
+    assigned.expire();
+    EXPECT_EQ(1, assigned.size());
+    EXPECT_TRUE(assigned.contains(2));
+
+    moved.insert(5, "Five");
+    EXPECT_EQ(1, moved.size());
+}
+
+TEST(LRUCacheTest, test_memory_usage) {
+    using namespace std::chrono_literals;
+    cake::LRUCache<int, std::string> cache(2);
+    const size_t emptyUsage = cache.memoryUsage();
+
+    cache.insert(1, "One");
+    const size_t oneEntryUsage = cache.memoryUsage();
+    EXPECT_GT(oneEntryUsage, emptyUsage);
+
+    // Evictions keep the usage bounded
+    cache.insert(2, "Two");
+    const size_t fullUsage = cache.memoryUsage();
+    cache.insert(3, "Three");
+    EXPECT_EQ(fullUsage, cache.memoryUsage());
+
+    // The timer wheel is created with the first entry that expires
+    cache.insert(4, "Four", 1s);
+    EXPECT_GT(cache.memoryUsage(), fullUsage);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,164 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <cake/AccessTrace.h>
+#include <cake/LRUCache.h>
+#include <cake/MissRatioCurve.h>
+
+namespace {
+std::string makeTrace(const std::vector<uint64_t> &keys) {
+    std::ostringstream output;
+    cake::AccessTraceWriter writer(output, 7);
+
+    for (const auto key : keys)
+        writer.write(key);
+
+    writer.flush();
+
+    return output.str();
+}
+
+std::vector<uint64_t> makeSkewedKeys(size_t numAccesses, uint64_t numKeys) {
+    std::mt19937_64 generator(42);
+    std::geometric_distribution<uint64_t> hot(0.02);
+    std::uniform_int_distribution<uint64_t> cold(0, numKeys - 1);
+    std::vector<uint64_t> keys;
+
+    for (size_t i = 0; i < numAccesses; ++i)
+        keys.push_back(i % 3 == 0 ? cold(generator) : hot(generator) % numKeys);
+
+    return keys;
+}
+
+double lruMissRatio(const std::vector<uint64_t> &keys, size_t cacheSize) {
+    cake::LRUCache<uint64_t, bool> cache(cacheSize);
+    size_t misses = 0;
+
+    for (const auto key : keys) {
+        if (!cache.contains(key)) {
+            ++misses;
+            cache.insert(key, true);
+        }
+    }
+
+    return static_cast<double>(misses) / keys.size();
+}
+} // namespace
+
+TEST(AccessTraceTest, roundTrip) {
+    const std::vector<uint64_t> keys = {1, 2, 3, 0xffffffffffffffff, 5, 1, 2, 8, 9, 10, 11};
+    std::istringstream input(makeTrace(keys) + "abc"); // Truncated key is ignored
+    cake::AccessTraceReader reader(input, 4);
+    std::vector<uint64_t> actual;
+    uint64_t key;
+
+    while (reader.next(key))
+        actual.push_back(key);
+
+    EXPECT_EQ(keys, actual);
+    EXPECT_FALSE(reader.next(key));
+}
+
+TEST(MissRatioCurveTest, emptyCurve) {
+    cake::MissRatioCurve curve;
+
+    EXPECT_EQ(0, curve.numAccesses());
+    EXPECT_EQ(0.0, curve.missRatio(10));
+    EXPECT_TRUE(curve.curve().empty());
+}
+
+TEST(MissRatioCurveTest, loop) {
+    cake::MissRatioCurve curve;
+
+    for (int round = 0; round < 4; ++round) {
+        for (uint64_t key = 0; key < 3; ++key)
+            curve.access(key);
+    }
+
+    EXPECT_EQ(12, curve.numAccesses());
+    EXPECT_EQ(1.0, curve.missRatio(0));
+    EXPECT_EQ(1.0, curve.missRatio(2));
+    EXPECT_EQ(0.25, curve.missRatio(3));
+    EXPECT_EQ(0.25, curve.missRatio(100));
+
+    const std::vector<std::pair<size_t, double>> expected = {{0, 1.0}, {3, 0.25}};
+    EXPECT_EQ(expected, curve.curve());
+}
+
+TEST(MissRatioCurveTest, matchesLRUCache) {
+    const auto keys = makeSkewedKeys(20000, 500);
+    std::istringstream input(makeTrace(keys));
+    cake::AccessTraceReader reader(input);
+    cake::MissRatioCurve curve;
+
+    curve.access(reader);
+    EXPECT_EQ(keys.size(), curve.numAccesses());
+
+    for (const size_t cacheSize : {1, 10, 50, 100, 300, 600}) {
+        EXPECT_DOUBLE_EQ(lruMissRatio(keys, cacheSize), curve.missRatio(cacheSize))
+            << "cacheSize = " << cacheSize;
+    }
+}
+
+TEST(MissRatioCurveTest, sampling) {
+    const auto keys = makeSkewedKeys(200000, 20000);
+    cake::MissRatioCurve curve(0.1);
+
+    for (const auto key : keys)
+        curve.access(key);
+
+    EXPECT_EQ(0.1, curve.samplingRate());
+
+    for (const size_t cacheSize : {100, 1000, 5000})
+        EXPECT_NEAR(lruMissRatio(keys, cacheSize), curve.missRatio(cacheSize), 0.05);
+}
+
+TEST(MissRatioCurveTest, comparePolicies) {
+    const auto keys = makeSkewedKeys(20000, 2000);
+    std::istringstream input(makeTrace(keys));
+    cake::AccessTraceReader reader(input);
+
+    const auto comparisons = cake::comparePolicies(reader, {10, 100, 1000});
+    ASSERT_EQ(3, comparisons.size());
+
+    for (const auto &comparison : comparisons) {
+        const double expected = lruMissRatio(keys, comparison.cacheSize);
+
+        EXPECT_DOUBLE_EQ(expected, comparison.lruMissRatio);
+        EXPECT_DOUBLE_EQ(expected, comparison.curveMissRatio);
+        EXPECT_GT(comparison.tinyLFUMissRatio, 0.0);
+        EXPECT_LT(comparison.tinyLFUMissRatio, 1.0);
+    }
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,88 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <set>
+
+#include <gtest/gtest.h>
+
+#include <cake/NodeArena.h>
+
+TEST(NodeArenaTest, allocate) {
+    cake::NodeArena arena;
+    std::set<void *> pointers;
+
+    EXPECT_EQ(arena.bytesReserved(), 0);
+
+    for (size_t size = 1; size < 1000; ++size) {
+        void *pointer = arena.allocate(size);
+
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(pointer) % 16, 0);
+        std::memset(pointer, 0xff, size);
+        EXPECT_TRUE(pointers.insert(pointer).second);
+    }
+
+    EXPECT_GT(arena.bytesReserved(), 0);
+}
+
+TEST(NodeArenaTest, reuseFreedMemory) {
+    cake::NodeArena arena;
+
+    void *small = arena.allocate(40);
+    void *large = arena.allocate(100000);
+
+    arena.deallocate(small, 40);
+    arena.deallocate(large, 100000);
+
+    // Same rounded size
+    EXPECT_EQ(arena.allocate(33), small);
+    EXPECT_EQ(arena.allocate(100000), large);
+    EXPECT_NE(arena.allocate(40), small);
+}
+
+TEST(NodeArenaTest, merge) {
+    cake::NodeArena arena;
+    cake::NodeArena other;
+
+    void *pointer = other.allocate(64);
+    const size_t reserved = other.bytesReserved();
+
+    other.deallocate(pointer, 64);
+    arena.merge(other);
+
+    EXPECT_EQ(other.bytesReserved(), 0);
+    EXPECT_EQ(arena.bytesReserved(), reserved);
+    EXPECT_EQ(arena.allocate(64), pointer);
+
+    cake::NodeArena moved(std::move(arena));
+
+    EXPECT_EQ(moved.bytesReserved(), reserved);
+    EXPECT_EQ(arena.bytesReserved(), 0);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,108 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <cake/DenseDisjointSet.h>
+#include <cake/OfflineConnectivity.h>
+
+TEST(OfflineConnectivityTest, noQueries) {
+    cake::OfflineConnectivity<int> connectivity(3);
+
+    connectivity.addEdge(0, 1);
+    EXPECT_TRUE(connectivity.solve().empty());
+}
+
+TEST(OfflineConnectivityTest, addAndRemove) {
+    cake::OfflineConnectivity<int> connectivity(4);
+
+    connectivity.query(0, 1);
+    connectivity.addEdge(0, 1);
+    connectivity.addEdge(1, 2);
+    connectivity.query(0, 2);
+    EXPECT_TRUE(connectivity.removeEdge(2, 1));
+    EXPECT_FALSE(connectivity.removeEdge(2, 1));
+    connectivity.query(0, 2);
+    connectivity.query(1, 0);
+
+    // A second copy keeps the edge after one removal
+    connectivity.addEdge(2, 3);
+    connectivity.addEdge(3, 2);
+    connectivity.removeEdge(2, 3);
+    EXPECT_EQ(connectivity.query(3, 2), 4);
+    EXPECT_EQ(connectivity.numQueries(), 5);
+
+    EXPECT_EQ(connectivity.solve(), std::vector<bool>({false, true, false, true, true}));
+}
+
+TEST(OfflineConnectivityTest, matchesRecomputation) {
+    const int numVertices = 30;
+    cake::OfflineConnectivity<int> connectivity(numVertices);
+    std::mt19937 generator(5);
+    std::uniform_int_distribution<int> vertex(0, numVertices - 1);
+    std::uniform_int_distribution<int> operation(0, 2);
+    std::vector<std::pair<int, int>> edges;
+    std::vector<bool> expected;
+
+    for (int i = 0; i < 600; ++i) {
+        const int vertex1 = vertex(generator);
+        const int vertex2 = vertex(generator);
+
+        switch (operation(generator)) {
+        case 0:
+            connectivity.addEdge(vertex1, vertex2);
+            edges.emplace_back(vertex1, vertex2);
+            break;
+        case 1:
+            if (!edges.empty()) {
+                const auto edge = edges[vertex1 % edges.size()];
+
+                EXPECT_TRUE(connectivity.removeEdge(edge.second, edge.first));
+                edges.erase(edges.begin() + vertex1 % edges.size());
+            }
+            break;
+        default: {
+            cake::DenseDisjointSet<int> sets(numVertices);
+
+            for (const auto &[from, to] : edges)
+                sets.join(from, to);
+
+            connectivity.query(vertex1, vertex2);
+            expected.push_back(sets.sameSet(vertex1, vertex2));
+            break;
+        }
+        }
+    }
+
+    EXPECT_EQ(connectivity.solve(), expected);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -22,12 +22,17 @@
  * SOFTWARE.
  */
 
+#include <algorithm>
+#include <random>
 #include <string>
 
 #include <gtest/gtest.h>
 
 #include <cake/PrefixTree.h>
 
+template <typename TString>
+using ScoredPrefixTree = cake::PrefixTree<TString, cake::NodeArena, double>;
+
 TEST(PrefixTreeTest, constructEmpty) {
     cake::PrefixTree<std::string> trie;
 
@@ -131,6 +136,433 @@ TEST(PrefixTreeTest, query) {
     }
 }
 
+TEST(PrefixTreeTest, removeKeepsSiblings) {
+    cake::PrefixTree<std::string> trie({"ab", "ac", "b"});
+
+    EXPECT_TRUE(trie.remove("ab"));
+    EXPECT_EQ(std::vector<std::string>({"ac"}), trie.query("a"));
+
+    EXPECT_TRUE(trie.remove("ac"));
+    EXPECT_TRUE(trie.query("a").empty());
+    EXPECT_EQ(std::vector<std::string>({"b"}), trie.query("b"));
+}
+
+TEST(PrefixTreeTest, largeFanOut) {
+    cake::PrefixTree<std::string> trie;
+    std::vector<std::string> expected;
+
+    // Every byte value, so that nodes grow through all their kinds. Results are ordered by
+    // unsigned byte value, as std::string comparison does.
+    for (int byte = 0; byte < 256; ++byte) {
+        const std::string word = std::string("x") + static_cast<char>(byte);
+        expected.push_back(word);
+        EXPECT_TRUE(trie.add(word));
+        EXPECT_EQ(trie.query("x").size(), byte + 1);
+    }
+
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(expected, trie.query("x"));
+
+    // And shrink them back
+    for (int byte = 255; byte >= 0; byte -= 2) {
+        EXPECT_TRUE(trie.remove(std::string("x") + static_cast<char>(byte)));
+        expected.erase(std::find(expected.begin(), expected.end(),
+                                 std::string("x") + static_cast<char>(byte)));
+        EXPECT_EQ(expected, trie.query("x"));
+    }
+
+    for (int byte = 254; byte >= 0; byte -= 2)
+        EXPECT_TRUE(trie.remove(std::string("x") + static_cast<char>(byte)));
+
+    EXPECT_EQ(0, trie.size());
+    EXPECT_TRUE(trie.query("x").empty());
+}
+
+TEST(PrefixTreeTest, wideSymbols) {
+    cake::PrefixTree<std::u32string> trie;
+    std::vector<std::u32string> expected;
+
+    for (char32_t symbol = 0x1F600; symbol < 0x1F600 + 100; symbol += 3) {
+        expected.push_back(std::u32string(U"ab") + symbol);
+        EXPECT_TRUE(trie.add(expected.back()));
+    }
+
+    EXPECT_EQ(expected, trie.query(U"a"));
+
+    for (size_t i = 0; i < expected.size(); i += 2)
+        EXPECT_TRUE(trie.remove(expected[i]));
+
+    std::vector<std::u32string> remaining;
+    for (size_t i = 1; i < expected.size(); i += 2)
+        remaining.push_back(expected[i]);
+
+    EXPECT_EQ(remaining, trie.query(U"ab"));
+}
+
+TEST(PrefixTreeTest, queryWithLimit) {
+    cake::PrefixTree<std::string> trie({"app", "apple", "application", "apt", "cake"});
+
+    EXPECT_EQ(trie.query("ap", 2), std::vector<std::string>({"app", "apple"}));
+    EXPECT_EQ(trie.query("ap", 10), trie.query("ap"));
+    EXPECT_EQ(trie.query("ap", 0), std::vector<std::string>());
+    EXPECT_EQ(trie.query("b", 3), std::vector<std::string>());
+
+    // Stops as soon as the limit is reached, also across node kinds
+    for (int byte = 0; byte < 256; ++byte)
+        trie.add(std::string("x") + static_cast<char>(byte));
+
+    EXPECT_EQ(trie.query("x", 1), std::vector<std::string>({std::string("x") + '\0'}));
+    EXPECT_EQ(trie.query("x", 200).size(), 200);
+}
+
+TEST(PrefixTreeTest, forEach) {
+    cake::PrefixTree<std::string> trie({"app", "apple", "application", "apt", "cake"});
+    std::vector<std::string> visited;
+
+    EXPECT_TRUE(trie.forEach("ap", [&](const std::string &word) {
+        visited.push_back(word);
+        return true;
+    }));
+    EXPECT_EQ(visited, trie.query("ap"));
+
+    visited.clear();
+    EXPECT_FALSE(trie.forEach("ap", [&](const std::string &word) {
+        visited.push_back(word);
+        return word != "apple";
+    }));
+    EXPECT_EQ(visited, std::vector<std::string>({"app", "apple"}));
+
+    EXPECT_TRUE(trie.forEach("b", [](const std::string &) { return false; }));
+
+    visited.clear();
+    EXPECT_TRUE(trie.forEach("", [&](const std::string &word) {
+        visited.push_back(word);
+        return true;
+    }));
+    EXPECT_EQ(visited, std::vector<std::string>({"app", "apple", "application", "apt", "cake"}));
+}
+
+TEST(PrefixTreeTest, topK) {
+    using Completions = std::vector<std::pair<std::string, double>>;
+
+    ScoredPrefixTree<std::string> trie;
+
+    EXPECT_TRUE(trie.add("app", 5.0));
+    EXPECT_TRUE(trie.add("apple", 9.0));
+    EXPECT_TRUE(trie.add("application", 7.0));
+    EXPECT_TRUE(trie.add("apt", 7.0));
+    EXPECT_TRUE(trie.add("cake", 10.0));
+    EXPECT_FALSE(trie.add("apple", 1.0));
+
+    EXPECT_EQ(trie.topK("ap", 3),
+              Completions({{"apple", 9.0}, {"application", 7.0}, {"apt", 7.0}}));
+    EXPECT_EQ(trie.topK("ap", 10).size(), 4);
+    EXPECT_EQ(trie.topK("ap", 0), Completions());
+    EXPECT_EQ(trie.topK("b", 3), Completions());
+    EXPECT_EQ(trie.topK("", 3), Completions());
+
+    // Scores propagate on updates
+    EXPECT_TRUE(trie.setScore("app", 20.0));
+    EXPECT_FALSE(trie.setScore("ap", 1.0));
+    EXPECT_EQ(trie.topK("a", 2), Completions({{"app", 20.0}, {"apple", 9.0}}));
+
+    EXPECT_TRUE(trie.setScore("app", 0.0));
+    EXPECT_TRUE(trie.remove("apple"));
+    EXPECT_EQ(trie.topK("a", 2), Completions({{"application", 7.0}, {"apt", 7.0}}));
+
+    EXPECT_TRUE(trie.remove("application"));
+    EXPECT_TRUE(trie.remove("apt"));
+    EXPECT_EQ(trie.topK("a", 2), Completions({{"app", 0.0}}));
+}
+
+TEST(PrefixTreeTest, topKMatchesSortedQuery) {
+    ScoredPrefixTree<std::string> trie;
+    std::vector<std::pair<std::string, double>> expected;
+
+    // Scores with ties, over nodes of every kind
+    for (int byte = 0; byte < 256; ++byte) {
+        for (int length = 1; length <= 3; ++length) {
+            const std::string word = "x" + std::string(length, static_cast<char>(byte));
+            const double score = (byte * 7 + length) % 13;
+
+            EXPECT_TRUE(trie.add(word, score));
+            expected.emplace_back(word, score);
+        }
+    }
+
+    std::sort(expected.begin(), expected.end(), [](const auto &a, const auto &b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    expected.resize(50);
+
+    EXPECT_EQ(trie.topK("x", 50), expected);
+}
+
+TEST(PrefixTreeTest, topKTiesInTreeOrder) {
+    // Words with the same score come in the order of the tree, by unsigned code unit, which
+    // differs from the order of std::wstring where wchar_t is signed
+    ScoredPrefixTree<std::wstring> trie;
+    const std::wstring high = {L'x', static_cast<wchar_t>(0x80000000u)};
+
+    EXPECT_TRUE(trie.add(high, 1.0));
+    EXPECT_TRUE(trie.add(L"xa", 1.0));
+    EXPECT_TRUE(trie.add(L"xb", 1.0));
+
+    const auto completions = trie.topK(L"x", 3);
+
+    ASSERT_EQ(completions.size(), 3);
+    EXPECT_EQ(completions[0].first, L"xa");
+    EXPECT_EQ(completions[1].first, L"xb");
+    EXPECT_EQ(completions[2].first, high);
+}
+
+TEST(PrefixTreeTest, bulkConstruction) {
+    std::mt19937 generator(5);
+    std::vector<std::string> words;
+
+    // Unsorted, with duplicates and empty words, and more than 48 first symbols
+    for (int i = 0; i < 20000; ++i) {
+        std::string word(generator() % 6, ' ');
+
+        for (auto &c : word)
+            c = static_cast<char>(i % 3 == 0 ? generator() % 256 : 'a' + generator() % 3);
+
+        words.push_back(word);
+    }
+
+    ScoredPrefixTree<std::string> incremental;
+
+    for (const auto &word : words)
+        incremental.add(word);
+
+    for (size_t numThreads : {1, 2, 8}) {
+        ScoredPrefixTree<std::string> trie(words, numThreads);
+
+        EXPECT_EQ(trie.size(), incremental.size());
+
+        for (const std::string prefix : {"a", "ab", "b", "c", "\x80", "\xff"})
+            EXPECT_EQ(trie.query(prefix), incremental.query(prefix));
+
+        EXPECT_EQ(trie.topK("a", 3), incremental.topK("a", 3));
+
+        // The tree stays fully usable
+        EXPECT_TRUE(trie.add("abcabc", 2.0));
+        EXPECT_EQ(trie.topK("a", 1).front().first, "abcabc");
+        EXPECT_TRUE(trie.remove("abcabc"));
+        EXPECT_EQ(trie.query("a"), incremental.query("a"));
+    }
+}
+
+TEST(PrefixTreeTest, bulkConstructionWideSymbols) {
+    std::vector<std::u32string> words;
+
+    for (char32_t symbol = 0; symbol < 100; ++symbol)
+        words.push_back(std::u32string(2, 0x10000 + symbol * 99 % 100));
+
+    cake::PrefixTree<std::u32string> trie(words, 4);
+
+    EXPECT_EQ(trie.size(), 100);
+    EXPECT_EQ(trie.query(std::u32string(1, 0x10000)),
+              std::vector<std::u32string>({std::u32string(2, 0x10000)}));
+}
+
+TEST(PrefixTreeTest, fuzzyQuery) {
+    cake::PrefixTree<std::string> trie({"cake", "cakes", "bake", "cat", "lake", "apple", "ca"});
+
+    EXPECT_EQ(trie.fuzzyQuery("cake", 0), std::vector<std::string>({"cake"}));
+    EXPECT_EQ(trie.fuzzyQuery("cake", 1),
+              std::vector<std::string>({"bake", "cake", "cakes", "lake"}));
+    EXPECT_EQ(trie.fuzzyQuery("cake", 2),
+              std::vector<std::string>({"bake", "ca", "cake", "cakes", "cat", "lake"}));
+    EXPECT_EQ(trie.fuzzyQuery("aplpe", 2), std::vector<std::string>({"apple"}));
+    EXPECT_EQ(trie.fuzzyQuery("", 2), std::vector<std::string>({"ca"}));
+    EXPECT_EQ(trie.fuzzyQuery("xyz", 1), std::vector<std::string>());
+}
+
+TEST(PrefixTreeTest, fuzzyQueryMatchesBruteForce) {
+    const auto distance = [](const std::string &a, const std::string &b) {
+        std::vector<size_t> row(b.size() + 1);
+
+        for (size_t j = 0; j <= b.size(); ++j)
+            row[j] = j;
+
+        for (size_t i = 1; i <= a.size(); ++i) {
+            size_t diagonal = row[0];
+
+            row[0] = i;
+
+            for (size_t j = 1; j <= b.size(); ++j) {
+                const size_t above = row[j];
+
+                row[j] = std::min({above + 1, row[j - 1] + 1, diagonal + (a[i - 1] != b[j - 1])});
+                diagonal = above;
+            }
+        }
+
+        return row[b.size()];
+    };
+
+    std::mt19937 generator(9);
+    std::vector<std::string> words;
+
+    for (int i = 0; i < 2000; ++i) {
+        std::string word(1 + generator() % 7, ' ');
+
+        for (auto &c : word)
+            c = static_cast<char>('a' + generator() % 4);
+
+        words.push_back(word);
+    }
+
+    cake::PrefixTree<std::string> trie(words);
+
+    for (const std::string query : {"abc", "dddd", "abcdabc", "b"}) {
+        for (size_t maxEdits = 0; maxEdits <= 2; ++maxEdits) {
+            std::vector<std::string> expected;
+
+            trie.forEach("", [&](const std::string &word) {
+                if (distance(word, query) <= maxEdits)
+                    expected.push_back(word);
+                return true;
+            });
+
+            EXPECT_EQ(trie.fuzzyQuery(query, maxEdits), expected);
+        }
+    }
+}
+
+TEST(PrefixTreeTest, heapNodeAllocator) {
+    cake::PrefixTree<std::string, cake::HeapNodeAllocator> trie({"app", "apple", "cake"}, 2);
+
+    EXPECT_TRUE(trie.add("application"));
+    EXPECT_TRUE(trie.remove("apple"));
+    EXPECT_EQ(trie.query("app"), std::vector<std::string>({"app", "application"}));
+}
+
+TEST(PrefixTreeTest, longWords) {
+    // Deep enough to overflow the stack if nodes were destroyed recursively
+    const std::string word(1000000, 'a');
+
+    {
+        cake::PrefixTree<std::string> trie;
+
+        EXPECT_TRUE(trie.add(word));
+        EXPECT_TRUE(trie.add(word + "b"));
+        EXPECT_TRUE(trie.remove(word));
+    }
+    {
+        cake::PrefixTree<std::string, cake::HeapNodeAllocator> trie;
+
+        EXPECT_TRUE(trie.add(word));
+    }
+}
+
+TEST(PrefixTreeTest, wideFanOut) {
+    cake::PrefixTree<std::u32string> trie;
+    std::vector<std::u32string> expected;
+
+    // Grows a node of wide symbols well past its first capacity, and back
+    for (char32_t symbol = 0; symbol < 1000; ++symbol) {
+        expected.push_back(std::u32string({U'x', 0x10000 + symbol * 7 % 1000}));
+        EXPECT_TRUE(trie.add(expected.back()));
+    }
+
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(trie.query(U"x"), expected);
+
+    while (expected.size() > 1) {
+        EXPECT_TRUE(trie.remove(expected.back()));
+        expected.pop_back();
+    }
+
+    EXPECT_EQ(trie.query(U"x"), expected);
+}
+
+TEST(PrefixTreeTest, move) {
+    cake::PrefixTree<std::string> trie({"app", "apple", "cake"});
+    cake::PrefixTree<std::string> moved(std::move(trie));
+
+    EXPECT_EQ(moved.size(), 3);
+    EXPECT_EQ(moved.query("app"), std::vector<std::string>({"app", "apple"}));
+
+    // The moved-from tree is empty and usable
+    EXPECT_EQ(trie.size(), 0);
+    EXPECT_EQ(trie.query("a"), std::vector<std::string>());
+    EXPECT_TRUE(trie.add("apricot"));
+    EXPECT_TRUE(trie.remove("apricot"));
+    EXPECT_TRUE(trie.add("apricot"));
+
+    // Assignment swaps the trees
+    trie = std::move(moved);
+    EXPECT_EQ(trie.size(), 3);
+    EXPECT_EQ(moved.query("a"), std::vector<std::string>({"apricot"}));
+}
+
+TEST(PrefixTreeTest, memoryUsage) {
+    using HeapPrefixTree = cake::PrefixTree<std::string, cake::HeapNodeAllocator>;
+
+    HeapPrefixTree trie;
+    const size_t emptyUsage = trie.memoryUsage();
+
+    const auto totalBytes = [](const auto &breakdown) {
+        return breakdown.node4.bytes + breakdown.node16.bytes + breakdown.node48.bytes +
+               breakdown.node256.bytes + breakdown.nodeN.bytes;
+    };
+
+    EXPECT_EQ(trie.memoryBreakdown().node4.numNodes, 1);
+    EXPECT_EQ(emptyUsage, sizeof(trie) + totalBytes(trie.memoryBreakdown()));
+
+    // The root grows into a Node48, with a Node4 per word
+    for (char symbol = 'a'; symbol <= 'z'; ++symbol)
+        EXPECT_TRUE(trie.add(std::string(1, symbol)));
+
+    auto breakdown = trie.memoryBreakdown();
+
+    EXPECT_EQ(breakdown.node4.numNodes, 26);
+    EXPECT_EQ(breakdown.node16.numNodes, 0);
+    EXPECT_EQ(breakdown.node48.numNodes, 1);
+    EXPECT_EQ(breakdown.node256.numNodes, 0);
+    EXPECT_EQ(breakdown.nodeN.numNodes, 0);
+    EXPECT_GT(trie.memoryUsage(), emptyUsage);
+    EXPECT_EQ(trie.memoryUsage(), sizeof(trie) + totalBytes(breakdown));
+
+    for (char symbol = 'a'; symbol <= 'z'; ++symbol)
+        EXPECT_TRUE(trie.remove(std::string(1, symbol)));
+
+    EXPECT_EQ(trie.memoryUsage(), emptyUsage);
+
+    // Bulk and parallel builds account for the same nodes
+    std::vector<std::string> words;
+
+    for (int i = 0; i < 1000; ++i)
+        words.push_back(std::to_string(i * 7919));
+
+    const HeapPrefixTree serial(words);
+    const HeapPrefixTree parallel(words, 4);
+
+    breakdown = parallel.memoryBreakdown();
+    EXPECT_EQ(serial.memoryUsage(), parallel.memoryUsage());
+    EXPECT_EQ(parallel.memoryUsage(), sizeof(parallel) + totalBytes(breakdown));
+
+    // The arena also counts the memory it holds for future nodes
+    const cake::PrefixTree<std::string> arenaTrie(words, 4);
+
+    EXPECT_EQ(totalBytes(arenaTrie.memoryBreakdown()), totalBytes(breakdown));
+    EXPECT_GE(arenaTrie.memoryUsage(), sizeof(arenaTrie) + totalBytes(breakdown));
+}
+
+TEST(PrefixTreeTest, scoresCostMemoryOnlyWhenUsed) {
+    const cake::PrefixTree<std::string, cake::HeapNodeAllocator> unscored({"a", "b"});
+    const cake::PrefixTree<std::string, cake::HeapNodeAllocator, double> scored({"a", "b"});
+    const auto unscoredBreakdown = unscored.memoryBreakdown();
+    const auto scoredBreakdown = scored.memoryBreakdown();
+
+    // A root and a node per word, each with a score and a subtree score when scored
+    ASSERT_EQ(unscoredBreakdown.node4.numNodes, 3);
+    ASSERT_EQ(scoredBreakdown.node4.numNodes, 3);
+    EXPECT_EQ(scoredBreakdown.node4.bytes - unscoredBreakdown.node4.bytes, 3 * 2 * sizeof(double));
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
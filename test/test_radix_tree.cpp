@@ -0,0 +1,155 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <random>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <cake/PrefixTree.h>
+#include <cake/RadixTree.h>
+
+TEST(RadixTreeTest, constructEmpty) {
+    cake::RadixTree<std::string> tree;
+
+    EXPECT_EQ(tree.size(), 0);
+    EXPECT_EQ(tree.numNodes(), 1);
+    EXPECT_TRUE(tree.query("a").empty());
+}
+
+TEST(RadixTreeTest, addSplitsEdges) {
+    cake::RadixTree<std::string> tree;
+
+    EXPECT_TRUE(tree.add("application"));
+    EXPECT_EQ(tree.numNodes(), 2);
+
+    EXPECT_TRUE(tree.add("apple"));
+    EXPECT_EQ(tree.numNodes(), 4);
+
+    EXPECT_TRUE(tree.add("app"));
+    EXPECT_EQ(tree.numNodes(), 5);
+
+    EXPECT_FALSE(tree.add("app"));
+    EXPECT_FALSE(tree.add(""));
+    EXPECT_EQ(tree.size(), 3);
+
+    EXPECT_EQ(tree.query("a"), std::vector<std::string>({"app", "apple", "application"}));
+    EXPECT_EQ(tree.query("appl"), std::vector<std::string>({"apple", "application"}));
+    EXPECT_EQ(tree.query("applic"), std::vector<std::string>({"application"}));
+    EXPECT_EQ(tree.query("apples"), std::vector<std::string>());
+    EXPECT_EQ(tree.query("b"), std::vector<std::string>());
+    EXPECT_EQ(tree.query(""), std::vector<std::string>());
+}
+
+TEST(RadixTreeTest, removeMergesEdges) {
+    cake::RadixTree<std::string> tree({"app", "apple", "application", "cake"});
+
+    EXPECT_FALSE(tree.remove("ap"));
+    EXPECT_FALSE(tree.remove("apples"));
+    EXPECT_FALSE(tree.remove("dog"));
+
+    EXPECT_TRUE(tree.remove("apple"));
+    EXPECT_FALSE(tree.remove("apple"));
+    EXPECT_EQ(tree.query("app"), std::vector<std::string>({"app", "application"}));
+
+    EXPECT_TRUE(tree.remove("app"));
+    EXPECT_EQ(tree.query("app"), std::vector<std::string>({"application"}));
+    EXPECT_EQ(tree.numNodes(), 3);
+
+    EXPECT_TRUE(tree.remove("application"));
+    EXPECT_TRUE(tree.remove("cake"));
+    EXPECT_EQ(tree.size(), 0);
+    EXPECT_EQ(tree.numNodes(), 1);
+}
+
+TEST(RadixTreeTest, wideSymbols) {
+    cake::RadixTree<std::u32string> tree({U"\U0001F370cake", U"\U0001F370pie", U"cake"});
+
+    EXPECT_EQ(tree.query(U"\U0001F370"),
+              std::vector<std::u32string>({U"\U0001F370cake", U"\U0001F370pie"}));
+    EXPECT_EQ(tree.query(U"c"), std::vector<std::u32string>({U"cake"}));
+}
+
+TEST(RadixTreeTest, matchesPrefixTree) {
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<int> length(1, 8);
+    std::uniform_int_distribution<int> symbol(0, 3);
+    const std::string alphabet = "ab\xc3\xff";
+
+    cake::PrefixTree<std::string> trie;
+    cake::RadixTree<std::string> tree;
+
+    auto randomWord = [&]() {
+        std::string word(length(generator), ' ');
+
+        for (auto &c : word) {
+            c = alphabet[symbol(generator)];
+        }
+
+        return word;
+    };
+
+    for (int i = 0; i < 2000; i++) {
+        const std::string word = randomWord();
+
+        if (i % 3 == 0) {
+            EXPECT_EQ(tree.remove(word), trie.remove(word));
+        } else {
+            EXPECT_EQ(tree.add(word), trie.add(word));
+        }
+
+        EXPECT_EQ(tree.size(), trie.size());
+    }
+
+    for (int i = 0; i < 200; i++) {
+        const std::string prefix = randomWord().substr(0, length(generator) % 4 + 1);
+
+        EXPECT_EQ(tree.query(prefix), trie.query(prefix));
+    }
+
+    EXPECT_LT(tree.numNodes(), 2 * tree.size() + 1);
+}
+
+TEST(RadixTreeTest, memoryUsage) {
+    cake::RadixTree<std::string> tree;
+    const size_t emptyUsage = tree.memoryUsage();
+
+    EXPECT_TRUE(tree.add("apple"));
+    const size_t oneWordUsage = tree.memoryUsage();
+    EXPECT_GT(oneWordUsage, emptyUsage);
+
+    // Splitting an edge adds a node, but no label symbols
+    EXPECT_TRUE(tree.add("app"));
+    EXPECT_GT(tree.memoryUsage(), oneWordUsage);
+
+    EXPECT_TRUE(tree.remove("app"));
+    EXPECT_EQ(tree.memoryUsage(), oneWordUsage);
+    EXPECT_TRUE(tree.remove("apple"));
+    EXPECT_EQ(tree.memoryUsage(), emptyUsage);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,113 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <cake/RollbackDisjointSet.h>
+
+TEST(RollbackDisjointSetTest, join) {
+    cake::RollbackDisjointSet<int> disjointSet(4);
+
+    EXPECT_TRUE(disjointSet.join(0, 1));
+    EXPECT_FALSE(disjointSet.join(1, 0));
+    EXPECT_TRUE(disjointSet.join(2, 3));
+    EXPECT_TRUE(disjointSet.join(1, 3));
+    EXPECT_TRUE(disjointSet.sameSet(0, 2));
+    EXPECT_EQ(disjointSet.setSize(2), 4);
+    EXPECT_EQ(disjointSet.numSets(), 1);
+
+    EXPECT_FALSE(disjointSet.join(-1, 0));
+    EXPECT_FALSE(disjointSet.join(0, 4));
+}
+
+TEST(RollbackDisjointSetTest, rollback) {
+    cake::RollbackDisjointSet<long long> disjointSet(5);
+
+    disjointSet.join(0, 1);
+    const auto checkpoint1 = disjointSet.checkpoint();
+
+    disjointSet.join(2, 3);
+    const auto checkpoint2 = disjointSet.checkpoint();
+
+    disjointSet.join(1, 3);
+    disjointSet.join(3, 4);
+    EXPECT_EQ(disjointSet.numSets(), 1);
+
+    disjointSet.rollback(checkpoint2);
+    EXPECT_EQ(disjointSet.numSets(), 3);
+    EXPECT_TRUE(disjointSet.sameSet(2, 3));
+    EXPECT_FALSE(disjointSet.sameSet(0, 3));
+    EXPECT_EQ(disjointSet.setSize(4), 1);
+
+    disjointSet.rollback(checkpoint1);
+    EXPECT_FALSE(disjointSet.sameSet(2, 3));
+    EXPECT_TRUE(disjointSet.sameSet(0, 1));
+    EXPECT_EQ(disjointSet.setSize(0), 2);
+
+    // Rolling back to a later checkpoint does nothing
+    disjointSet.rollback(checkpoint2);
+    EXPECT_EQ(disjointSet.numSets(), 4);
+}
+
+TEST(RollbackDisjointSetTest, nestedRollbacks) {
+    const int numElements = 200;
+    cake::RollbackDisjointSet<int> disjointSet(numElements);
+    std::mt19937 generator(3);
+    std::uniform_int_distribution<int> element(0, numElements - 1);
+    std::vector<std::vector<int>> roots;
+    std::vector<cake::RollbackDisjointSet<int>::Checkpoint> checkpoints;
+
+    // Records the state at every checkpoint, and checks it is restored by its rollback
+    for (int level = 0; level < 10; ++level) {
+        roots.emplace_back();
+
+        for (int i = 0; i < numElements; ++i)
+            roots.back().push_back(disjointSet.find(i));
+
+        checkpoints.push_back(disjointSet.checkpoint());
+
+        for (int i = 0; i < 20; ++i)
+            disjointSet.join(element(generator), element(generator));
+    }
+
+    while (!checkpoints.empty()) {
+        disjointSet.rollback(checkpoints.back());
+
+        for (int i = 0; i < numElements; ++i)
+            EXPECT_EQ(disjointSet.find(i), roots.back()[i]);
+
+        checkpoints.pop_back();
+        roots.pop_back();
+    }
+
+    EXPECT_EQ(disjointSet.numSets(), numElements);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,186 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <cake/BloomFilter.h>
+#include <cake/Hash.h>
+#include <cake/Simd.h>
+
+namespace {
+/// Levels supported by the CPU running the tests
+std::vector<cake::Simd::Level> supportedLevels() {
+    std::vector<cake::Simd::Level> levels;
+
+    for (auto level : {cake::Simd::Level::Generic, cake::Simd::Level::Sse42,
+                       cake::Simd::Level::Avx2, cake::Simd::Level::Avx512}) {
+        if (level <= cake::Simd::supportedLevel())
+            levels.push_back(level);
+    }
+
+    return levels;
+}
+
+std::vector<uint64_t> randomWords(size_t numWords, std::mt19937_64 &generator) {
+    std::vector<uint64_t> words(numWords);
+
+    for (auto &word : words)
+        word = generator();
+
+    return words;
+}
+
+/// Forces a level for the duration of a test, and restores the one detected at the end
+class SimdTest : public ::testing::Test {
+  protected:
+    void TearDown() override { cake::Simd::setLevel(cake::Simd::supportedLevel()); }
+};
+} // namespace
+
+TEST_F(SimdTest, setLevel) {
+    EXPECT_EQ(cake::Simd::activeLevel(), cake::Simd::supportedLevel());
+
+    for (const auto level : supportedLevels()) {
+        EXPECT_TRUE(cake::Simd::setLevel(level));
+        EXPECT_EQ(cake::Simd::activeLevel(), level);
+    }
+
+    if (cake::Simd::supportedLevel() != cake::Simd::Level::Avx512) {
+        const auto active = cake::Simd::activeLevel();
+
+        EXPECT_FALSE(cake::Simd::setLevel(cake::Simd::Level::Avx512));
+        EXPECT_EQ(cake::Simd::activeLevel(), active);
+    }
+
+    EXPECT_STREQ(cake::Simd::levelName(cake::Simd::Level::Avx2), "avx2");
+}
+
+TEST_F(SimdTest, popcount) {
+    std::mt19937_64 generator(2022);
+
+    for (size_t numWords = 0; numWords <= 40; ++numWords) {
+        const auto words = randomWords(numWords, generator);
+        uint64_t expected = 0;
+
+        for (const auto word : words)
+            expected += __builtin_popcountll(word);
+
+        for (const auto level : supportedLevels()) {
+            cake::Simd::setLevel(level);
+            EXPECT_EQ(cake::Simd::popcount(words.data(), words.size()), expected)
+                << cake::Simd::levelName(level) << ", " << numWords << " words";
+        }
+    }
+
+    const std::vector<uint64_t> ones(1000, ~uint64_t(0));
+
+    for (const auto level : supportedLevels()) {
+        cake::Simd::setLevel(level);
+        EXPECT_EQ(cake::Simd::popcount(ones.data(), ones.size()), 64000);
+    }
+}
+
+TEST_F(SimdTest, bitwiseOr) {
+    std::mt19937_64 generator(2022);
+
+    for (size_t numWords = 0; numWords <= 40; ++numWords) {
+        const auto target = randomWords(numWords, generator);
+        const auto source = randomWords(numWords, generator);
+        std::vector<uint64_t> expected(numWords);
+
+        for (size_t i = 0; i < numWords; ++i)
+            expected[i] = target[i] | source[i];
+
+        for (const auto level : supportedLevels()) {
+            auto merged = target;
+
+            cake::Simd::setLevel(level);
+            cake::Simd::bitwiseOr(merged.data(), source.data(), numWords);
+            EXPECT_EQ(merged, expected) << cake::Simd::levelName(level) << ", " << numWords
+                                        << " words";
+        }
+    }
+}
+
+TEST_F(SimdTest, murmur64A) {
+    std::mt19937_64 generator(2022);
+    std::string data;
+
+    for (size_t i = 0; i < 40; ++i)
+        data.push_back(static_cast<char>(generator()));
+
+    for (size_t numSeeds = 0; numSeeds <= 19; ++numSeeds) {
+        const auto seeds = randomWords(numSeeds, generator);
+
+        for (size_t size = 0; size <= data.size(); ++size) {
+            std::vector<uint64_t> expected(numSeeds);
+
+            for (size_t i = 0; i < numSeeds; ++i)
+                expected[i] = cake::Hash::murmur64A(data.data(), size, seeds[i]);
+
+            for (const auto level : supportedLevels()) {
+                // One more hash than asked for, which must be left alone
+                std::vector<uint64_t> hashes(numSeeds + 1, 7);
+
+                cake::Simd::setLevel(level);
+                cake::Simd::murmur64A(data.data(), size, seeds.data(), hashes.data(), numSeeds);
+                EXPECT_EQ(hashes.back(), 7);
+                hashes.pop_back();
+                EXPECT_EQ(hashes, expected) << cake::Simd::levelName(level) << ", " << size
+                                            << " bytes, " << numSeeds << " seeds";
+            }
+        }
+    }
+}
+
+TEST_F(SimdTest, bloomFilter) {
+    // Filters built under every level must be the same
+    std::vector<double> occupancies;
+
+    for (const auto level : supportedLevels()) {
+        cake::Simd::setLevel(level);
+
+        cake::BloomFilter bloomFilter(1000, 0.01);
+
+        for (int i = 0; i < 1000; i += 2)
+            bloomFilter.add(i);
+
+        for (int i = 0; i < 1000; i += 2)
+            EXPECT_TRUE(bloomFilter.contains(i)) << cake::Simd::levelName(level);
+
+        occupancies.push_back(bloomFilter.occupancy());
+    }
+
+    for (const auto occupancy : occupancies)
+        EXPECT_EQ(occupancy, occupancies.front());
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
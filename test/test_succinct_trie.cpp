@@ -0,0 +1,229 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <cake/PrefixTree.h>
+#include <cake/SuccinctTrie.h>
+
+TEST(SuccinctTrieTest, constructEmpty) {
+    cake::SuccinctTrie<std::string> trie;
+
+    EXPECT_EQ(trie.size(), 0);
+    EXPECT_EQ(trie.numNodes(), 1);
+    EXPECT_FALSE(trie.contains("a"));
+    EXPECT_TRUE(trie.query("a").empty());
+}
+
+TEST(SuccinctTrieTest, constructWithWordContainer) {
+    cake::SuccinctTrie<std::string> trie({"cat", "apple", "", "cake", "app", "apple", "brave"});
+
+    EXPECT_EQ(trie.size(), 5);
+    EXPECT_TRUE(trie.contains("app"));
+    EXPECT_TRUE(trie.contains("apple"));
+    EXPECT_TRUE(trie.contains("cake"));
+    EXPECT_FALSE(trie.contains("ap"));
+    EXPECT_FALSE(trie.contains("apples"));
+    EXPECT_FALSE(trie.contains(""));
+
+    EXPECT_EQ(trie.query("a"), std::vector<std::string>({"app", "apple"}));
+    EXPECT_EQ(trie.query("ca"), std::vector<std::string>({"cake", "cat"}));
+    EXPECT_EQ(trie.query("d"), std::vector<std::string>());
+    EXPECT_EQ(trie.query(""), std::vector<std::string>());
+}
+
+TEST(SuccinctTrieTest, matchesPrefixTree) {
+    std::mt19937 generator(11);
+    const std::string alphabet = "abc\x80\xff";
+    cake::PrefixTree<std::string> tree;
+
+    for (int i = 0; i < 3000; ++i) {
+        std::string word(1 + generator() % 10, ' ');
+
+        for (auto &c : word)
+            c = alphabet[generator() % alphabet.size()];
+
+        tree.add(word);
+    }
+
+    cake::SuccinctTrie<std::string> trie(tree);
+
+    EXPECT_EQ(trie.size(), tree.size());
+
+    for (const std::string prefix : {"a", "b", "ab", "\x80", "\xff\xff", "cab", "abcabc"})
+        EXPECT_EQ(trie.query(prefix), tree.query(prefix));
+
+    tree.forEach("", [&](const std::string &word) {
+        EXPECT_TRUE(trie.contains(word));
+        return true;
+    });
+
+    // Scores are dropped, but scored trees convert as well
+    const cake::PrefixTree<std::string, cake::NodeArena, double> scored({"app", "apple", "cake"});
+
+    EXPECT_EQ(cake::SuccinctTrie<std::string>(scored).query("ap"), scored.query("ap"));
+}
+
+TEST(SuccinctTrieTest, wideSymbols) {
+    cake::PrefixTree<std::u16string> tree({u"été", u"￿a", u"école", u"eat"});
+    cake::SuccinctTrie<std::u16string> trie(tree);
+
+    EXPECT_EQ(trie.query(u"é"), tree.query(u"é"));
+    EXPECT_EQ(trie.query(u"￿"), std::vector<std::u16string>({u"￿a"}));
+    EXPECT_TRUE(trie.contains(u"eat"));
+}
+
+TEST(SuccinctTrieTest, saveAndLoad) {
+    cake::SuccinctTrie<std::string> trie({"app", "apple", "application", "cake"});
+    std::stringstream stream;
+
+    EXPECT_TRUE(trie.save(stream));
+    EXPECT_EQ(stream.str().size(), trie.sizeInBytes());
+
+    cake::SuccinctTrie<std::string> loaded;
+
+    EXPECT_TRUE(loaded.load(stream));
+    EXPECT_EQ(loaded.size(), 4);
+    EXPECT_EQ(loaded.query("app"), trie.query("app"));
+
+    // Images of other symbol types or truncated images are rejected
+    std::stringstream truncated(stream.str().substr(0, stream.str().size() - 8));
+    std::stringstream wide(stream.str());
+    cake::SuccinctTrie<std::u32string> wideTrie;
+
+    EXPECT_FALSE(loaded.load(truncated));
+    EXPECT_FALSE(wideTrie.load(wide));
+    EXPECT_EQ(loaded.query("app"), trie.query("app"));
+
+    // An image in memory is used in place
+    std::vector<uint64_t> image(trie.sizeInBytes() / sizeof(uint64_t));
+    cake::SuccinctTrie<std::string> viewed;
+
+    std::memcpy(image.data(), stream.str().data(), trie.sizeInBytes());
+    EXPECT_TRUE(viewed.view(image.data(), trie.sizeInBytes()));
+    EXPECT_TRUE(viewed.contains("application"));
+}
+
+TEST(SuccinctTrieTest, corruptStructure) {
+    using Trie = cake::SuccinctTrie<std::string>;
+
+    // The image of {"ab"}: edges 'a' and 'b', each the first child of its parent
+    const auto makeImage = [](const std::vector<bool> &hasChildren) {
+        std::vector<uint64_t> image = {Trie::magic, Trie::version | uint64_t(1) << 32, 1, 2,
+                                       'a' | 'b' << 8};
+
+        cake::BitVector::appendImage(image, {true, true});
+        cake::BitVector::appendImage(image, hasChildren);
+        cake::BitVector::appendImage(image, {false, false, true});
+
+        return image;
+    };
+
+    const auto valid = makeImage({true, true, false});
+    Trie trie;
+
+    ASSERT_TRUE(trie.view(valid.data(), valid.size() * sizeof(uint64_t)));
+    EXPECT_EQ(trie.query("a"), std::vector<std::string>({"ab"}));
+
+    // The node of "ab" claims the edge that leads to itself, which would make walks loop
+    const auto cyclic = makeImage({true, false, true});
+
+    EXPECT_FALSE(trie.view(cyclic.data(), cyclic.size() * sizeof(uint64_t)));
+    EXPECT_EQ(trie.query("a"), std::vector<std::string>({"ab"}));
+}
+
+TEST(SuccinctTrieTest, corruptBits) {
+    cake::SuccinctTrie<std::string> trie({"ab", "ac", "b", "bcd"});
+    std::stringstream stream;
+
+    ASSERT_TRUE(trie.save(stream));
+
+    std::vector<uint64_t> image(trie.sizeInBytes() / sizeof(uint64_t));
+
+    std::memcpy(image.data(), stream.str().data(), trie.sizeInBytes());
+
+    // Zeroes the bits of firstChild, which follow the header and the 6 labels, but keeps the
+    // stored totals
+    image[4 + 1 + 1] = 0;
+
+    cake::SuccinctTrie<std::string> viewed;
+
+    EXPECT_FALSE(viewed.view(image.data(), trie.sizeInBytes()));
+    EXPECT_FALSE(viewed.contains("ab"));
+}
+
+TEST(SuccinctTrieTest, map) {
+    std::vector<std::string> words;
+
+    for (int i = 0; i < 10000; ++i)
+        words.push_back("word" + std::to_string(i * 7919));
+
+    const std::string path = testing::TempDir() + "succinct_trie_test.bin";
+
+    {
+        cake::SuccinctTrie<std::string> trie(words);
+        std::ofstream output(path, std::ios::binary);
+
+        EXPECT_TRUE(trie.save(output));
+
+        // Smaller than the words themselves
+        size_t wordBytes = 0;
+
+        for (const auto &word : words)
+            wordBytes += word.size();
+
+        EXPECT_LT(trie.sizeInBytes(), wordBytes);
+    }
+
+    cake::SuccinctTrie<std::string> trie;
+
+    EXPECT_FALSE(trie.map(path + ".missing"));
+    ASSERT_TRUE(trie.map(path));
+    EXPECT_EQ(trie.size(), words.size());
+
+    for (const auto &word : words)
+        EXPECT_TRUE(trie.contains(word));
+
+    EXPECT_EQ(trie.query("word7919"),
+              std::vector<std::string>({"word7919", "word79190", "word791900", "word7919000"}));
+
+    // Moving keeps the mapping alive
+    cake::SuccinctTrie<std::string> moved = std::move(trie);
+
+    EXPECT_TRUE(moved.contains("word0"));
+
+    std::remove(path.c_str());
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,132 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <cake/TimerWheel.h>
+
+TEST(TimerWheelTest, constructor) {
+    cake::TimerWheel<int> wheel(100);
+
+    EXPECT_EQ(100, wheel.currentTick());
+    EXPECT_EQ(0, wheel.size());
+}
+
+TEST(TimerWheelTest, fireInDeadlineOrder) {
+    cake::TimerWheel<int> wheel;
+    std::vector<int> fired;
+    const auto onExpired = [&fired](int value) { fired.push_back(value); };
+
+    wheel.schedule(3, 3000);
+    wheel.schedule(1, 10);
+    wheel.schedule(2, 70);
+    EXPECT_EQ(3, wheel.size());
+
+    wheel.advance(9, onExpired);
+    EXPECT_TRUE(fired.empty());
+
+    wheel.advance(10, onExpired);
+    EXPECT_EQ(std::vector<int>({1}), fired);
+
+    wheel.advance(2999, onExpired);
+    EXPECT_EQ(std::vector<int>({1, 2}), fired);
+
+    wheel.advance(3000, onExpired);
+    EXPECT_EQ(std::vector<int>({1, 2, 3}), fired);
+    EXPECT_EQ(0, wheel.size());
+    EXPECT_EQ(3000, wheel.currentTick());
+}
+
+TEST(TimerWheelTest, pastDeadlineFiresOnNextTick) {
+    cake::TimerWheel<int> wheel(50);
+    std::vector<int> fired;
+
+    wheel.schedule(1, 10);
+    wheel.advance(51, [&fired](int value) { fired.push_back(value); });
+
+    EXPECT_EQ(std::vector<int>({1}), fired);
+}
+
+TEST(TimerWheelTest, cancel) {
+    cake::TimerWheel<int> wheel;
+    std::vector<int> fired;
+
+    const auto handle1 = wheel.schedule(1, 100);
+    wheel.schedule(2, 100);
+    const auto handle3 = wheel.schedule(3, 100000);
+
+    wheel.cancel(handle1);
+    wheel.cancel(handle3);
+    EXPECT_EQ(1, wheel.size());
+
+    wheel.advance(1000000, [&fired](int value) { fired.push_back(value); });
+    EXPECT_EQ(std::vector<int>({2}), fired);
+}
+
+TEST(TimerWheelTest, deadlineBeyondRange) {
+    cake::TimerWheel<int> wheel;
+    const uint64_t deadline = static_cast<uint64_t>(1) << 40;
+    uint64_t firedAt = 0;
+
+    wheel.schedule(1, deadline);
+
+    for (uint64_t tick = deadline >> 4; tick <= deadline; tick += deadline >> 4)
+        wheel.advance(tick - 1, [&](int) { firedAt = wheel.currentTick(); });
+
+    EXPECT_EQ(0, firedAt);
+
+    wheel.advance(deadline, [&](int) { firedAt = wheel.currentTick(); });
+    EXPECT_EQ(deadline, firedAt);
+}
+
+TEST(TimerWheelTest, randomDeadlines) {
+    cake::TimerWheel<int> wheel(12345);
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<uint64_t> distribution(1, 1 << 20);
+    std::vector<uint64_t> deadlines;
+
+    for (int i = 0; i < 2000; ++i) {
+        deadlines.push_back(wheel.currentTick() + distribution(generator));
+        wheel.schedule(i, deadlines.back());
+    }
+
+    size_t numFired = 0;
+    for (uint64_t tick = 12345; wheel.size() > 0; tick += 997) {
+        wheel.advance(tick, [&](int value) {
+            EXPECT_LE(deadlines[value], tick);
+            EXPECT_GT(deadlines[value], tick - 997);
+            ++numFired;
+        });
+    }
+
+    EXPECT_EQ(deadlines.size(), numFired);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,139 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <cake/LRUCache.h>
+#include <cake/TinyLFUCache.h>
+
+TEST(TinyLFUCacheTest, constructor) {
+    {
+        cake::TinyLFUCache<int, std::string> cache(0);
+
+        EXPECT_EQ(1, cache.maxSize());
+        EXPECT_EQ(0, cache.size());
+    }
+    {
+        cake::TinyLFUCache<int, std::string> cache(100);
+
+        EXPECT_EQ(100, cache.maxSize());
+        EXPECT_EQ(0, cache.size());
+    }
+}
+
+TEST(TinyLFUCacheTest, sizeOneCache) {
+    cake::TinyLFUCache<int, std::string> cache(1);
+
+    cache.insert(1, "One");
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_EQ(1, cache.size());
+
+    cache[2] = "Two";
+    EXPECT_TRUE(cache.contains(2));
+    EXPECT_FALSE(cache.contains(1));
+    EXPECT_EQ(1, cache.size());
+
+    EXPECT_TRUE(cache.remove(2));
+    EXPECT_EQ(0, cache.size());
+}
+
+TEST(TinyLFUCacheTest, insertAndAccess) {
+    cake::TinyLFUCache<int, std::string> cache(10);
+
+    for (int i = 0; i < 10; ++i)
+        cache.insert(i, std::to_string(i));
+
+    EXPECT_EQ(10, cache.size());
+
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(cache.contains(i));
+        EXPECT_EQ(std::to_string(i), cache[i]);
+    }
+
+    cache.insert(3, "Three");
+    EXPECT_EQ("Three", cache[3]);
+    EXPECT_EQ(10, cache.size());
+
+    for (int i = 10; i < 100; ++i) {
+        cache[i] = std::to_string(i);
+        EXPECT_TRUE(cache.contains(i));
+        EXPECT_LE(cache.size(), 10);
+    }
+}
+
+TEST(TinyLFUCacheTest, remove) {
+    cake::TinyLFUCache<int, std::string> cache(4);
+
+    for (int i = 0; i < 4; ++i)
+        cache.insert(i, std::to_string(i));
+
+    cache.contains(0);
+    cache.contains(0);
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(cache.remove(i));
+        EXPECT_FALSE(cache.contains(i));
+    }
+
+    EXPECT_FALSE(cache.remove(0));
+    EXPECT_EQ(0, cache.size());
+}
+
+TEST(TinyLFUCacheTest, scanResistance) {
+    const int cacheSize = 100;
+    const int hotSetSize = 50;
+    cake::TinyLFUCache<int, std::string> tinyLFU(cacheSize);
+    cake::LRUCache<int, std::string> lru(cacheSize);
+
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < hotSetSize; ++i) {
+            tinyLFU[i] = "hot";
+            lru[i] = "hot";
+        }
+    }
+
+    // A scan over many keys that are never accessed again
+    for (int i = 1000; i < 11000; ++i) {
+        tinyLFU.insert(i, "cold");
+        lru.insert(i, "cold");
+    }
+
+    int tinyLFUHits = 0;
+    int lruHits = 0;
+
+    for (int i = 0; i < hotSetSize; ++i) {
+        tinyLFUHits += tinyLFU.contains(i) ? 1 : 0;
+        lruHits += lru.contains(i) ? 1 : 0;
+    }
+
+    EXPECT_EQ(0, lruHits);
+    EXPECT_GE(tinyLFUHits, hotSetSize * 9 / 10);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
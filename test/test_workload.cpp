@@ -0,0 +1,177 @@
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Mario Rincon Nigro
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <cake/BloomFilter.h>
+#include <cake/LRUCache.h>
+#include <cake/Workload.h>
+
+TEST(WorkloadTest, zipfian) {
+    const uint64_t numKeys = 1000;
+    const size_t numDraws = 200000;
+    cake::ZipfianGenerator generator(numKeys, 0.99, 1);
+    std::vector<size_t> counts(numKeys);
+
+    for (size_t i = 0; i < numDraws; ++i) {
+        const uint64_t key = generator.next();
+
+        ASSERT_LT(key, numKeys);
+        ++counts[key];
+    }
+
+    double zeta = 0.0;
+
+    for (uint64_t rank = 1; rank <= numKeys; ++rank)
+        zeta += std::pow(static_cast<double>(rank), -0.99);
+
+    // The two first keys are drawn exactly, the rest approximately
+    EXPECT_NEAR(static_cast<double>(counts[0]) / numDraws, 1.0 / zeta, 0.01);
+    EXPECT_NEAR(static_cast<double>(counts[1]) / numDraws, std::pow(2.0, -0.99) / zeta, 0.01);
+    EXPECT_GT(counts[9], counts[99]);
+    EXPECT_GT(counts[99], counts[999]);
+}
+
+TEST(WorkloadTest, zipfianEdgeCases) {
+    cake::ZipfianGenerator single(0);
+    cake::ZipfianGenerator uniform(100, 0.0, 2);
+    std::vector<size_t> counts(100);
+
+    EXPECT_EQ(single.numKeys(), 1);
+    EXPECT_EQ(single.next(), 0);
+
+    for (size_t i = 0; i < 100000; ++i)
+        ++counts[uniform.next()];
+
+    EXPECT_GT(*std::min_element(counts.begin(), counts.end()), 800);
+    EXPECT_LT(*std::max_element(counts.begin(), counts.end()), 1200);
+}
+
+TEST(WorkloadTest, scrambledZipfian) {
+    cake::ScrambledZipfianGenerator generator1(1000, 0.99, 3);
+    cake::ScrambledZipfianGenerator generator2(1000, 0.99, 3);
+    std::vector<size_t> counts(1000);
+
+    for (size_t i = 0; i < 100000; ++i) {
+        const uint64_t key = generator1.next();
+
+        ASSERT_LT(key, 1000);
+        EXPECT_EQ(key, generator2.next());
+        ++counts[key];
+    }
+
+    // Still skewed, but the most popular key is somewhere else
+    const auto hottest = std::max_element(counts.begin(), counts.end());
+
+    EXPECT_NE(hottest, counts.begin());
+    EXPECT_GT(*hottest, 5000);
+}
+
+TEST(WorkloadTest, temporalLocality) {
+    cake::TemporalLocalityGenerator generator(100, 1000, 50);
+
+    for (uint64_t phase = 0; phase < 5; ++phase) {
+        for (size_t i = 0; i < 1000; ++i) {
+            const uint64_t key = generator.next();
+
+            ASSERT_GE(key, phase * 50);
+            ASSERT_LT(key, phase * 50 + 100);
+        }
+    }
+}
+
+TEST(WorkloadTest, corpora) {
+    const auto words = cake::Corpus::words(1000, 4);
+    const auto urls = cake::Corpus::urls(1000, 4);
+    const auto uuids = cake::Corpus::uuids(1000, 4);
+
+    ASSERT_EQ(words.size(), 1000);
+    ASSERT_EQ(urls.size(), 1000);
+    ASSERT_EQ(uuids.size(), 1000);
+    EXPECT_EQ(cake::Corpus::words(1000, 4), words);
+
+    // Words repeat
+    EXPECT_LT(std::set<std::string>(words.begin(), words.end()).size(), 500);
+
+    for (const auto &url : urls)
+        EXPECT_EQ(url.rfind("https://www.", 0), 0);
+
+    for (const auto &uuid : uuids) {
+        ASSERT_EQ(uuid.size(), 36);
+        EXPECT_EQ(uuid[8], '-');
+        EXPECT_EQ(uuid[14], '4');
+        EXPECT_NE(std::string("89ab").find(uuid[19]), std::string::npos);
+    }
+
+    EXPECT_EQ(std::set<std::string>(uuids.begin(), uuids.end()).size(), 1000);
+}
+
+TEST(WorkloadTest, replay) {
+    const auto makeTrace = [](auto generator) {
+        std::ostringstream output;
+        cake::AccessTraceWriter writer(output);
+
+        cake::writeTrace(generator, 100000, writer);
+        writer.flush();
+
+        return output.str();
+    };
+
+    const std::string skewedTrace = makeTrace(cake::ScrambledZipfianGenerator(100000, 0.99));
+    const std::string uniformTrace = makeTrace(cake::ZipfianGenerator(100000, 0.0));
+
+    std::istringstream skewedInput(skewedTrace);
+    std::istringstream uniformInput(uniformTrace);
+    cake::AccessTraceReader skewedReader(skewedInput);
+    cake::AccessTraceReader uniformReader(uniformInput);
+    cake::LRUCache<uint64_t, bool> skewedCache(1000);
+    cake::LRUCache<uint64_t, bool> uniformCache(1000);
+
+    const auto skewed = cake::replayCache(skewedReader, skewedCache);
+    const auto uniform = cake::replayCache(uniformReader, uniformCache);
+
+    EXPECT_EQ(skewed.numAccesses, 100000);
+    EXPECT_EQ(uniform.numAccesses, 100000);
+    EXPECT_GT(skewed.hitRatio(), 0.3);
+    EXPECT_LT(uniform.hitRatio(), 0.05);
+
+    // Any structure can be driven by the keys of a trace
+    std::istringstream input(skewedTrace);
+    cake::AccessTraceReader reader(input);
+    cake::BloomFilter filter(100000, 0.01);
+
+    EXPECT_EQ(cake::replayTrace(reader, [&](uint64_t key) { filter.add(key); }), 100000);
+    EXPECT_GT(filter.occupancy(), 0.0);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}